@@ -0,0 +1,56 @@
+/*
+ * ActiveTiles.cpp
+ * Tracks which square tiles of a board need to be stepped. A tile is only
+ * stepped if it or one of its eight neighboring tiles changed during the
+ * previous generation.
+ */
+
+#include "ActiveTiles.hpp"
+
+namespace GameOfLife {
+
+// split a width x height board into tiles of tile_size x tile_size cells,
+// where tiles on opposite edges are neighbors if the board wraps around
+ActiveTiles::ActiveTiles(unsigned int width, unsigned int height,
+                         unsigned int tile_size, bool wrap)
+        : width(width), height(height), tile_size(tile_size), wrap(wrap),
+          tile_rows((height + tile_size - 1) / tile_size),
+          tile_cols((width + tile_size - 1) / tile_size),
+          active(tile_rows * tile_cols, 1), changed(tile_rows * tile_cols, 0) {
+} // ActiveTiles()
+
+// step every tile next generation, e.g. after the board is refilled
+void ActiveTiles::activate_all() {
+    std::fill(active.begin(), active.end(), 1);
+    std::fill(changed.begin(), changed.end(), 0);
+} // activate_all()
+
+// finish a generation, activating every tile next to a changed one
+void ActiveTiles::advance() {
+    // spread changes sideways into active, then up and down back into changed
+    for (unsigned int row = 0; row < tile_rows; ++row) {
+        unsigned char *from = &changed[row * tile_cols];
+        unsigned char *to = &active[row * tile_cols];
+        for (unsigned int col = 0; col < tile_cols; ++col) {
+            to[col] = from[col] | (col > 0 ? from[col - 1] : 0) |
+                      (col + 1 < tile_cols ? from[col + 1] : 0);
+        } // for
+        if (wrap) {
+            to[0] |= from[tile_cols - 1];
+            to[tile_cols - 1] |= from[0];
+        } // if
+    }     // for
+    for (unsigned int row = 0; row < tile_rows; ++row) {
+        unsigned int above = row > 0 ? row - 1 : wrap ? tile_rows - 1 : row;
+        unsigned int below = row + 1 < tile_rows ? row + 1 : wrap ? 0 : row;
+        for (unsigned int col = 0; col < tile_cols; ++col) {
+            changed[row * tile_cols + col] = active[row * tile_cols + col] |
+                                             active[above * tile_cols + col] |
+                                             active[below * tile_cols + col];
+        } // for
+    }     // for
+    active.swap(changed);
+    std::fill(changed.begin(), changed.end(), 0);
+} // advance()
+
+} // namespace GameOfLife
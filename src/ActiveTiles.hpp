@@ -0,0 +1,88 @@
+/*
+ * ActiveTiles.hpp
+ * Tracks which square tiles of a board need to be stepped. A tile is only
+ * stepped if it or one of its eight neighboring tiles changed during the
+ * previous generation.
+ */
+
+#ifndef ActiveTiles_hpp
+#define ActiveTiles_hpp
+
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <stdio.h>
+#include <vector>
+
+namespace GameOfLife {
+
+class ActiveTiles {
+public:
+    // split a width x height board into tiles of tile_size x tile_size
+    // cells, where tiles on opposite edges are neighbors if the board wraps
+    // around
+    ActiveTiles(unsigned int width, unsigned int height,
+                unsigned int tile_size, bool wrap);
+
+    // step every tile next generation, e.g. after the board is refilled
+    void activate_all();
+    // record that a cell in the tile changed, or may change by chance
+    void mark_changed(unsigned int tile_row, unsigned int tile_col) {
+        changed[tile_row * tile_cols + tile_col] = 1;
+    }
+    // finish a generation, activating every tile next to a changed one
+    void advance();
+    // call step_tile(tile_row, tile_col) on every active tile, where it steps
+    // the tile's cells and returns whether any changed or had a chance to,
+    // then finish the generation; each row of tiles is a separate task for
+    // the pool, and step_tile is a template parameter so it gets inlined
+    template <typename StepTile>
+    void step_active(ThreadPool &pool, StepTile &&step_tile) {
+        pool.run(tile_rows, [&](unsigned int tile_row) {
+            for (unsigned int tile_col = 0; tile_col < tile_cols; ++tile_col) {
+                if (is_active(tile_row, tile_col) &&
+                    step_tile(tile_row, tile_col)) {
+                    mark_changed(tile_row, tile_col);
+                } // if
+            }     // for
+        });
+        advance();
+    } // step_active()
+    // whether the tile needs to be stepped this generation
+    bool is_active(unsigned int tile_row, unsigned int tile_col) const {
+        return active[tile_row * tile_cols + tile_col] != 0;
+    }
+
+    unsigned int get_tile_rows() const {
+        return tile_rows;
+    }
+    unsigned int get_tile_cols() const {
+        return tile_cols;
+    }
+    // the number of tiles, numbered row by row
+    unsigned int get_tile_count() const {
+        return tile_rows * tile_cols;
+    }
+    // the cells covered by a tile, as half-open ranges
+    unsigned int row_begin(unsigned int tile_row) const {
+        return tile_row * tile_size;
+    }
+    unsigned int row_end(unsigned int tile_row) const {
+        return std::min(height, (tile_row + 1) * tile_size);
+    }
+    unsigned int col_begin(unsigned int tile_col) const {
+        return tile_col * tile_size;
+    }
+    unsigned int col_end(unsigned int tile_col) const {
+        return std::min(width, (tile_col + 1) * tile_size);
+    }
+
+private:
+    unsigned int width, height, tile_size;
+    bool wrap;
+    unsigned int tile_rows, tile_cols;
+    std::vector<unsigned char> active;
+    std::vector<unsigned char> changed;
+};
+
+} // namespace GameOfLife
+#endif /* ActiveTiles_hpp */
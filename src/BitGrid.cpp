@@ -0,0 +1,149 @@
+/*
+ * BitGrid.cpp
+ * A board of cells packed 64 to a word, stepped a whole word at a time
+ * with bit-parallel adders. Each row has a ghost word on either side and
+ * the board a ghost row above and below, so stepping never checks bounds.
+ */
+
+#include "BitGrid.hpp"
+#include "CounterRandom.hpp"
+#include <algorithm>
+
+namespace GameOfLife {
+
+// construct an empty board
+BitGrid::BitGrid(unsigned int width, unsigned int height)
+        : width(width), height(height),
+          words_per_row((width + WORD_BITS - 1) / WORD_BITS),
+          stride(words_per_row + 2), last_word_mask(~std::uint64_t{0}),
+          words() {
+    if (width % WORD_BITS != 0) {
+        last_word_mask = (std::uint64_t{1} << (width % WORD_BITS)) - 1;
+    } // if
+    words.resize(static_cast<std::size_t>(stride) * (height + 2), 0);
+} // BitGrid()
+
+// kill every cell on the board
+void BitGrid::clear() {
+    std::fill(words.begin(), words.end(), 0);
+} // clear()
+
+// return whether the cell at (row, col) is alive
+bool BitGrid::get(unsigned int row, unsigned int col) const {
+    return (row_data(row)[col / WORD_BITS] >> (col % WORD_BITS)) & 1;
+} // get()
+
+// set the cell at (row, col) to alive or dead
+void BitGrid::set(unsigned int row, unsigned int col, bool alive) {
+    std::uint64_t &word = row_data(row)[col / WORD_BITS];
+    std::uint64_t bit = std::uint64_t{1} << (col % WORD_BITS);
+    word = alive ? word | bit : word & ~bit;
+} // set()
+
+// kill any cells written past the right edge of the board
+void BitGrid::clear_padding() {
+    for (unsigned int row = 0; row < height; ++row) {
+        row_data(row)[words_per_row - 1] &= last_word_mask;
+    } // for
+} // clear_padding()
+
+// count the living cells on the board
+unsigned int BitGrid::count_alive() const {
+    unsigned int alive = 0;
+    for (unsigned int row = 0; row < height; ++row) {
+        const std::uint64_t *row_words = row_data(row);
+        for (unsigned int word = 0; word + 1 < words_per_row; ++word) {
+            alive += static_cast<unsigned int>(
+                    __builtin_popcountll(row_words[word]));
+        } // for
+        alive += static_cast<unsigned int>(__builtin_popcountll(
+                row_words[words_per_row - 1] & last_word_mask));
+    } // for
+    return alive;
+} // count_alive()
+
+// copy the opposite edges of the board into the ghost cells around it, so the
+// next step wraps around like a torus
+void BitGrid::wrap_halo() {
+    unsigned int last_col = width - 1;
+    for (unsigned int row = 0; row < height; ++row) {
+        std::uint64_t *row_words = row_data(row);
+        // the last column west of the first, in the top bit of the ghost word
+        row_words[-1] = ((row_words[last_col / WORD_BITS] >>
+                          (last_col % WORD_BITS)) & 1) << 63;
+        // the first column east of the last, in the first bit past the edge
+        std::uint64_t first = row_words[0] & 1;
+        if (width % WORD_BITS == 0) {
+            row_words[words_per_row] = first;
+        } else {
+            std::uint64_t &last = row_words[words_per_row - 1];
+            last = (last & last_word_mask) | (first << (width % WORD_BITS));
+        } // if/else
+    }     // for
+    // the last row above the first and the first below the last, corners
+    // included
+    std::copy(row_data(height - 1) - 1, row_data(height - 1) - 1 + stride,
+              row_data(0) - 1 - stride);
+    std::copy(row_data(0) - 1, row_data(0) - 1 + stride,
+              row_data(height - 1) - 1 + stride);
+} // wrap_halo()
+
+// write the next generation of current into next using rule; births by chance
+// draw from the random numbers of each cell in generation of the board
+// identified by random_key
+void BitGrid::step(const BitGrid &current, BitGrid &next, const Rule &rule,
+                   std::uint64_t random_key, std::uint64_t generation) {
+    step(current, next, rule, 0, current.height, 0, current.words_per_row,
+         random_key, generation);
+} // step()
+
+// step only the given rows and words, returning whether any cell changed or
+// had a chance to
+bool BitGrid::step(const BitGrid &current, BitGrid &next, const Rule &rule,
+                   unsigned int row_begin, unsigned int row_end,
+                   unsigned int word_begin, unsigned int word_end,
+                   std::uint64_t random_key, std::uint64_t generation) {
+    unsigned int words_per_row = current.words_per_row;
+    std::uint64_t changed = 0;
+    for (unsigned int row = row_begin; row < row_end; ++row) {
+        // the ghost rows stand in past the top and bottom edges
+        const std::uint64_t *middle = current.row_data(row);
+        const std::uint64_t *above = middle - current.stride;
+        const std::uint64_t *below = middle + current.stride;
+        std::uint64_t *out = next.row_data(row);
+        for (unsigned int word = word_begin; word < word_end; ++word) {
+            NeighborCount count = count_neighbors(above, middle, below, word);
+            out[word] = next_state(count, middle[word], rule);
+            if (rule.is_deterministic()) {
+                continue;
+            } // if
+            // roll for each cell that may be born by chance, which counts as
+            // a change since it could have been
+            std::uint64_t candidates =
+                    chance_births(count, middle[word], rule) &
+                    current.board_mask(word);
+            changed |= candidates;
+            for (; candidates != 0; candidates &= candidates - 1) {
+                unsigned int bit =
+                        static_cast<unsigned int>(__builtin_ctzll(candidates));
+                CounterRandom random(random_key, generation,
+                                     row * current.width + word * WORD_BITS +
+                                             bit);
+                if (random.uniform() <= rule.birth_chance(count.at(bit))) {
+                    out[word] |= std::uint64_t{1} << bit;
+                } // if
+            }     // for
+        }         // for
+        // keep the bits past the right edge of the board dead
+        if (word_end == words_per_row) {
+            out[words_per_row - 1] &= current.last_word_mask;
+        } // if
+        for (unsigned int word = word_begin; word < word_end; ++word) {
+            // ignoring the ghost cell past the edge
+            changed |= (out[word] ^ middle[word]) & current.board_mask(word);
+        } // for
+    }     // for
+    return changed != 0;
+} // step()
+
+} // namespace GameOfLife
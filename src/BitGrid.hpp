@@ -0,0 +1,209 @@
+/*
+ * BitGrid.hpp
+ * A board of cells packed 64 to a word, stepped a whole word at a time
+ * with bit-parallel adders. Each row has a ghost word on either side and
+ * the board a ghost row above and below, so stepping never checks bounds.
+ */
+
+#ifndef BitGrid_hpp
+#define BitGrid_hpp
+
+#include "Rule.hpp"
+#include <cstdint>
+#include <stdio.h>
+#include <vector>
+
+namespace GameOfLife {
+
+class BitGrid {
+public:
+    // bit-sliced count (0 - 8) of the living neighbors of 64 cells
+    struct NeighborCount {
+        std::uint64_t bit0, bit1, bit2, bit3;
+
+        // the count of the cell in bit
+        int at(unsigned int bit) const {
+            return static_cast<int>(((bit0 >> bit) & 1) |
+                                    ((bit1 >> bit) & 1) << 1 |
+                                    ((bit2 >> bit) & 1) << 2 |
+                                    ((bit3 >> bit) & 1) << 3);
+        }
+    };
+
+    // construct an empty board
+    BitGrid(unsigned int width, unsigned int height);
+
+    // kill every cell on the board
+    void clear();
+    // return whether the cell at (row, col) is alive
+    bool get(unsigned int row, unsigned int col) const;
+    // set the cell at (row, col) to alive or dead
+    void set(unsigned int row, unsigned int col, bool alive);
+    // count the living cells on the board
+    unsigned int count_alive() const;
+    // copy the opposite edges of the board into the ghost cells around it,
+    // so the next step wraps around like a torus; the ghost cells are dead
+    // otherwise
+    void wrap_halo();
+
+    // write the next generation of current into next using rule; births by
+    // chance draw from the random numbers of each cell in generation of the
+    // board identified by random_key
+    static void step(const BitGrid &current, BitGrid &next, const Rule &rule,
+                     std::uint64_t random_key = 0,
+                     std::uint64_t generation = 0);
+    // step only the given rows and words, returning whether any cell changed
+    // or had a chance to
+    static bool step(const BitGrid &current, BitGrid &next, const Rule &rule,
+                     unsigned int row_begin, unsigned int row_end,
+                     unsigned int word_begin, unsigned int word_end,
+                     std::uint64_t random_key = 0,
+                     std::uint64_t generation = 0);
+
+    // the eight neighbors of every cell in word of row, lined up with the
+    // bits of the cells, in scan order from northwest to southeast; the rows
+    // directly above and below are each readable one word past either end
+    static void neighbor_words(const std::uint64_t *above,
+                               const std::uint64_t *row,
+                               const std::uint64_t *below, unsigned int word,
+                               std::uint64_t n[8]) {
+        n[0] = west(above, word);
+        n[1] = above[word];
+        n[2] = east(above, word);
+        n[3] = west(row, word);
+        n[4] = east(row, word);
+        n[5] = west(below, word);
+        n[6] = below[word];
+        n[7] = east(below, word);
+    } // neighbor_words()
+
+    // count the living neighbors of every cell in word of row, given the rows
+    // directly above and below, each readable one word past either end
+    static NeighborCount count_neighbors(const std::uint64_t *above,
+                                         const std::uint64_t *row,
+                                         const std::uint64_t *below,
+                                         unsigned int word) {
+        std::uint64_t n[8];
+        neighbor_words(above, row, below, word, n);
+        return add_neighbors(n);
+    } // count_neighbors()
+
+    // count the living neighbors of 64 cells given their eight neighbors,
+    // each lined up with the bits of the cells
+    static NeighborCount add_neighbors(const std::uint64_t n[8]) {
+        // add the neighbors in groups of three with full adders
+        std::uint64_t sum_a = n[0] ^ n[1] ^ n[2];
+        std::uint64_t carry_a = (n[0] & n[1]) | (n[2] & (n[0] ^ n[1]));
+        std::uint64_t sum_b = n[3] ^ n[4] ^ n[5];
+        std::uint64_t carry_b = (n[3] & n[4]) | (n[5] & (n[3] ^ n[4]));
+        std::uint64_t sum_c = n[6] ^ n[7];
+        std::uint64_t carry_c = n[6] & n[7];
+
+        // ones place
+        NeighborCount count;
+        count.bit0 = sum_a ^ sum_b ^ sum_c;
+        std::uint64_t carry_d = (sum_a & sum_b) | (sum_c & (sum_a ^ sum_b));
+
+        // twos place, from the four carries out of the ones place
+        std::uint64_t sum_e = carry_a ^ carry_b ^ carry_c;
+        std::uint64_t carry_e =
+                (carry_a & carry_b) | (carry_c & (carry_a ^ carry_b));
+        count.bit1 = sum_e ^ carry_d;
+        std::uint64_t carry_f = sum_e & carry_d;
+
+        // fours and eights places
+        count.bit2 = carry_e ^ carry_f;
+        count.bit3 = carry_e & carry_f;
+        return count;
+    } // add_neighbors()
+
+    // the cells among 64 with exactly neighbors living neighbors
+    static std::uint64_t count_equals(const NeighborCount &count,
+                                      unsigned int neighbors) {
+        // all ones where the bit of neighbors is set
+        std::uint64_t one = ~std::uint64_t{0};
+        return ~((count.bit0 ^ (neighbors & 1 ? one : 0)) |
+                 (count.bit1 ^ (neighbors & 2 ? one : 0)) |
+                 (count.bit2 ^ (neighbors & 4 ? one : 0)) |
+                 (count.bit3 ^ (neighbors & 8 ? one : 0)));
+    } // count_equals()
+
+    // apply the deterministic part of rule to 64 cells given their neighbor
+    // counts, one term per number of neighbors that leaves a cell alive
+    static std::uint64_t next_state(const NeighborCount &count,
+                                    std::uint64_t alive, const Rule &rule) {
+        std::uint64_t next = 0;
+        for (const Rule::Term *term = rule.terms_begin();
+             term != rule.terms_end(); ++term) {
+            next |= count_equals(count, term->neighbors) &
+                    ((alive & term->if_alive) | (~alive & term->if_dead));
+        } // for
+        return next;
+    } // next_state()
+
+    // the dead cells among 64 that may be born by chance under rule
+    static std::uint64_t chance_births(const NeighborCount &count,
+                                       std::uint64_t alive, const Rule &rule) {
+        std::uint64_t candidates = 0;
+        for (unsigned int neighbors = 0; neighbors <= Rule::MAX_NEIGHBORS;
+             ++neighbors) {
+            if ((rule.get_chance_mask() >> neighbors) & 1) {
+                candidates |= count_equals(count, neighbors);
+            } // if
+        }     // for
+        return candidates & ~alive;
+    } // chance_births()
+
+    unsigned int get_width() const {
+        return width;
+    }
+    unsigned int get_height() const {
+        return height;
+    }
+    // the number of words holding a single row
+    unsigned int get_words_per_row() const {
+        return words_per_row;
+    }
+    // words from one row to the next, including the ghost words
+    unsigned int get_stride() const {
+        return stride;
+    }
+    // the bits of word in each row that lie on the board
+    std::uint64_t board_mask(unsigned int word) const {
+        return word + 1 == words_per_row ? last_word_mask : ~std::uint64_t{0};
+    }
+    // the packed words of a row, column 0 in the lowest bit of the first word
+    const std::uint64_t *row_data(unsigned int row) const {
+        return &words[(static_cast<std::size_t>(row) + 1) * stride + 1];
+    }
+    std::uint64_t *row_data(unsigned int row) {
+        return &words[(static_cast<std::size_t>(row) + 1) * stride + 1];
+    }
+    // kill any cells written past the right edge of the board
+    void clear_padding();
+
+    static constexpr unsigned int WORD_BITS = 64;
+
+private:
+    // each cell's western neighbor, shifted into the cell's bit
+    static std::uint64_t west(const std::uint64_t *row, unsigned int word) {
+        const std::uint64_t *cells = row + word;
+        return (cells[0] << 1) | (cells[-1] >> 63);
+    }
+    // each cell's eastern neighbor, shifted into the cell's bit
+    static std::uint64_t east(const std::uint64_t *row, unsigned int word) {
+        const std::uint64_t *cells = row + word;
+        return (cells[0] >> 1) | (cells[1] << 63);
+    }
+
+    unsigned int width, height, words_per_row;
+    // words from one row to the next, including the ghost words
+    unsigned int stride;
+    // bits of the last word in each row that lie on the board; the first bit
+    // past the edge doubles as a ghost cell
+    std::uint64_t last_word_mask;
+    std::vector<std::uint64_t> words;
+};
+
+} // namespace GameOfLife
+#endif /* BitGrid_hpp */
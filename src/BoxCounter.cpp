@@ -0,0 +1,64 @@
+/*
+ * BoxCounter.cpp
+ * Counts the living cells in a row of boxes on a packed board, for drawing
+ * a board with more cells than the window has pixels.
+ */
+
+#include "BoxCounter.hpp"
+#include <algorithm>
+
+namespace GameOfLife {
+
+// construct counters for rows of words_per_row words
+BoxCounter::BoxCounter(unsigned int words_per_row)
+        : words_per_row(words_per_row), planes(), before(words_per_row + 1) {
+} // BoxCounter()
+
+// add a packed row of cells to the counters
+void BoxCounter::add_row(const std::uint64_t *words) {
+    for (unsigned int word = 0; word < words_per_row; ++word) {
+        // ripple the row's bits up the planes like a binary counter
+        std::uint64_t carry = words[word];
+        for (std::size_t plane = 0; carry != 0; ++plane) {
+            if (plane == planes.size()) {
+                planes.emplace_back(words_per_row + 1, 0);
+            } // if
+            std::uint64_t &bits = planes[plane][word];
+            std::uint64_t sum = bits ^ carry;
+            carry &= bits;
+            bits = sum;
+        } // for
+    } // for
+} // add_row()
+
+// add the living cells added since the last call between columns edges[i]
+// and edges[i + 1] to counts[i], for every i, and start over
+void BoxCounter::take_counts(const std::vector<unsigned int> &edges,
+                             std::uint32_t *counts) {
+    for (std::size_t plane = 0; plane < planes.size(); ++plane) {
+        std::vector<std::uint64_t> &bits = planes[plane];
+        std::uint32_t total = 0;
+        for (unsigned int word = 0; word <= words_per_row; ++word) {
+            before[word] = total;
+            total += static_cast<std::uint32_t>(
+                    __builtin_popcountll(bits[word]));
+        } // for
+        // how many of the plane's cells are set before column col
+        auto set_before = [&](unsigned int col) {
+            unsigned int word = col / WORD_BITS;
+            std::uint64_t below = (std::uint64_t{1} << (col % WORD_BITS)) - 1;
+            return before[word] + static_cast<std::uint32_t>(
+                                          __builtin_popcountll(bits[word] &
+                                                               below));
+        };
+        std::uint32_t left = set_before(edges[0]);
+        for (std::size_t box = 0; box + 1 < edges.size(); ++box) {
+            std::uint32_t right = set_before(edges[box + 1]);
+            counts[box] += (right - left) << plane;
+            left = right;
+        } // for
+        std::fill(bits.begin(), bits.end(), 0);
+    } // for
+} // take_counts()
+
+} // namespace GameOfLife
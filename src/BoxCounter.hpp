@@ -0,0 +1,42 @@
+/*
+ * BoxCounter.hpp
+ * Counts the living cells in a row of boxes on a packed board, for drawing
+ * a board with more cells than the window has pixels. The rows of the boxes
+ * are added up a word at a time into bit-sliced counters first, so each box
+ * then costs a few popcounts however tall or wide it is.
+ */
+
+#ifndef BoxCounter_hpp
+#define BoxCounter_hpp
+
+#include <cstdint>
+#include <stdio.h>
+#include <vector>
+
+namespace GameOfLife {
+
+class BoxCounter {
+public:
+    // construct counters for rows of words_per_row words
+    explicit BoxCounter(unsigned int words_per_row);
+
+    // add a packed row of cells to the counters
+    void add_row(const std::uint64_t *words);
+    // add the living cells added since the last call between columns
+    // edges[i] and edges[i + 1] to counts[i], for every i, and start over
+    void take_counts(const std::vector<unsigned int> &edges,
+                     std::uint32_t *counts);
+
+private:
+    static constexpr unsigned int WORD_BITS = 64;
+
+    unsigned int words_per_row;
+    // bit k of each column's count, packed like the rows; one more word
+    // than a row, so the column just past the board can be looked up
+    std::vector<std::vector<std::uint64_t>> planes;
+    // how many cells of a plane are set before each of its words
+    std::vector<std::uint32_t> before;
+};
+
+} // namespace GameOfLife
+#endif /* BoxCounter_hpp */
@@ -0,0 +1,27 @@
+/*
+ * Canvas.hpp
+ * What a model tells the screen as it steps. The views implement it with
+ * SFML and draw the model's boards themselves once per displayed frame; the
+ * models only see this interface, so they build and run without any
+ * display library.
+ */
+
+#ifndef Canvas_hpp
+#define Canvas_hpp
+
+#include <cstdint>
+#include <stdio.h>
+
+namespace GameOfLife {
+
+class Canvas {
+public:
+    virtual ~Canvas() {}
+
+    // the model has finished stepping or refilling its board, which has to
+    // be drawn again
+    virtual void set_generations(std::uint64_t generations) = 0;
+};
+
+} // namespace GameOfLife
+#endif /* Canvas_hpp */
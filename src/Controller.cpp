@@ -0,0 +1,57 @@
+/*
+ * Controller.cpp
+ * A general class representing a controller for any game mode
+ */
+
+#include "Controller.hpp"
+
+namespace GameOfLife {
+
+// zoom the view with the mouse wheel or the + and - keys, pan it by dragging
+// with the left mouse button, and show the whole board again with Home
+void Controller::on_view_event(const sf::Event &event) {
+    View &view = get_view();
+    switch (event.type) {
+        case sf::Event::MouseWheelScrolled:
+            if (event.mouseWheelScroll.delta != 0) {
+                view.zoom(event.mouseWheelScroll.delta > 0 ? 1 : -1,
+                          event.mouseWheelScroll.x, event.mouseWheelScroll.y);
+            } // if
+            break;
+        case sf::Event::MouseButtonPressed:
+            if (event.mouseButton.button == sf::Mouse::Left) {
+                is_dragging = true;
+                drag_x = event.mouseButton.x;
+                drag_y = event.mouseButton.y;
+            } // if
+            break;
+        case sf::Event::MouseButtonReleased:
+            if (event.mouseButton.button == sf::Mouse::Left) {
+                is_dragging = false;
+            } // if
+            break;
+        case sf::Event::MouseMoved:
+            if (is_dragging) {
+                view.pan(event.mouseMove.x - drag_x,
+                         event.mouseMove.y - drag_y);
+                drag_x = event.mouseMove.x;
+                drag_y = event.mouseMove.y;
+            } // if
+            break;
+        case sf::Event::KeyPressed:
+            if (event.key.code == sf::Keyboard::Equal ||
+                event.key.code == sf::Keyboard::Add) {
+                view.zoom(1);
+            } else if (event.key.code == sf::Keyboard::Hyphen ||
+                       event.key.code == sf::Keyboard::Subtract) {
+                view.zoom(-1);
+            } else if (event.key.code == sf::Keyboard::Home) {
+                view.show_all();
+            } // if
+            break;
+        default:
+            break;
+    } // switch
+} // on_view_event()
+
+} // namespace GameOfLife
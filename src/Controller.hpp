@@ -7,28 +7,90 @@
 #define Controller_hpp
 
 #include "Model.hpp"
+#include "PhaseTimers.hpp"
+#include "Simulation.hpp"
 #include "View.hpp"
 #include <SFML/System.hpp>
+#include <algorithm>
 #include <stdio.h>
 #include <string>
 namespace GameOfLife {
 
 class Controller {
 public:
+    // how many frames the window draws a second
+    static constexpr unsigned int FRAME_RATE = 60;
+    // how many turbo levels the speed rises through once the delay is zero
+    static constexpr unsigned int TURBO_LEVELS = 4;
+
     // constructor
-    Controller() : is_paused(true) {}
+    Controller()
+            : is_paused(true), timers(), frame_budget(1.0 / FRAME_RATE),
+              is_dragging(false), drag_x(0), drag_y(0) {}
 
     // display the view
     virtual void display_view() = 0;
 
-    // update the underlying model
-    virtual void update_model() = 0;
+    // step a generation once every given number of seconds, or once a
+    // frame if that's sooner; at a turbo level above zero, step as many
+    // generations each frame as fit in a share of the frame budget instead,
+    // which doubles with each level up to all of it
+    virtual void set_speed(double delay, unsigned int turbo) = 0;
+
+    // spend at most the given number of seconds of each frame stepping at
+    // the top turbo level
+    void set_frame_budget(double seconds) {
+        frame_budget = seconds;
+    }
 
     // act if key is pressed
     virtual void on_key_press(const sf::Event &event) = 0;
 
+    // zoom the view with the mouse wheel or the + and - keys, pan it by
+    // dragging with the left mouse button, and show the whole board again
+    // with Home
+    void on_view_event(const sf::Event &event);
+
+    // time each frame and show where it goes in the title bar, also
+    // writing it to files named log_file_name_N.csv unless that's empty
+    void enable_timing(const std::string &log_file_name) {
+        timers.set_enabled(true);
+        if (!log_file_name.empty()) {
+            timers.set_log(log_file_name);
+        } // if
+    }
+
 protected:
+    // the view the board is drawn with
+    virtual View &get_view() = 0;
+
+    // send the speed set_speed() describes to simulation
+    template <typename Frame>
+    void pace(Simulation<Frame> &simulation, double delay,
+              unsigned int turbo) const {
+        double frame = 1.0 / FRAME_RATE;
+        if (turbo == 0) {
+            simulation.set_delay(std::max(delay, frame));
+        } else {
+            turbo = std::min(turbo, TURBO_LEVELS);
+            simulation.set_budget(
+                    frame_budget / (1u << (TURBO_LEVELS - turbo)), frame);
+        } // if
+    }
+
+    // whether the model is paused, as last sent to its simulation
     bool is_paused;
+    // shared with the model and the view, which time their own phases on
+    // their own threads
+    PhaseTimers timers;
+    // the seconds of each frame spent stepping at the top turbo level
+    double frame_budget;
+
+private:
+    // whether the left mouse button is dragging the view, and where the
+    // mouse last was while it did
+    bool is_dragging;
+    int drag_x, drag_y;
 
 }; // Controller
 
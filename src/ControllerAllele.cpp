@@ -9,46 +9,76 @@ namespace GameOfLife {
 // construct an AlleleController
 ControllerAllele::ControllerAllele(unsigned int width, unsigned int height,
                                    double prob_alive, double dom_frequency,
+                                   const ModelOptions &options,
                                    sf::RenderWindow &window,
                                    std::string output_file_name)
         : Controller(), width(width), height(height), window(window),
-          view(width, height, window, output_file_name),
-          model(width, height, prob_alive, dom_frequency, view) {
+          view(width, height, window),
+          // the view learns of each generation from the frames it's shown,
+          // since the model is stepped on another thread
+          model(width, height, prob_alive, dom_frequency, options, nullptr,
+                output_file_name),
+          simulation(
+                  [this]() {
+                      ScopedPhase phase(&timers, PhaseTimers::STEP);
+                      model.update();
+                  },
+                  [this](Frame &frame) {
+                      frame.alive = model.get_alive();
+                      frame.dominant[0] = model.get_dominant(0);
+                      frame.dominant[1] = model.get_dominant(1);
+                      frame.generations = model.get_generations();
+                      frame.is_recording = model.get_is_recording();
+                  },
+                  Frame{BitGrid(width, height),
+                        {BitGrid(width, height), BitGrid(width, height)},
+                        0, false}) {
+    model.set_timers(&timers);
+    view.set_timers(&timers);
+    simulation.start();
 } // ControllerAllele()
 
 // display the view of the current board
 void ControllerAllele::display_view() {
+    bool is_new = simulation.take_frame();
+    const Frame &frame = simulation.get_frame();
+    if (is_new) {
+        view.set_generations(frame.generations);
+        view.set_recording(frame.is_recording);
+    } // if
+    timers.tick(frame.generations,
+                static_cast<std::uint64_t>(width) * height);
+    view.render(frame.alive, frame.dominant[0], frame.dominant[1]);
     view.display();
 } // display_view()
 
-// update the underlying board
-void ControllerAllele::update_model() {
-    if (!is_paused) {
-        model.update();
-    } // if
-} // update_model()
+// step at the given delay or turbo level
+void ControllerAllele::set_speed(double delay, unsigned int turbo) {
+    pace(simulation, delay, turbo);
+    view.set_turbo(turbo);
+} // set_speed()
 
 // handle key press events
 void ControllerAllele::on_key_press(const sf::Event &event) {
     // pause and unpase the game
     if (event.key.code == sf::Keyboard::P) {
         is_paused = !is_paused;
+        simulation.set_paused(is_paused);
     } // if
 
     // toggle whether data is currently being recorded
     if (event.key.code == sf::Keyboard::N) {
-        view.toggle_recording();
-        model.toggle_recording();
+        simulation.send([this]() { model.toggle_recording(); });
     } // if
 
     // if paused, step through a single generation
     if (is_paused && event.key.code == sf::Keyboard::U) {
-        model.update();
+        simulation.step_once();
     } // if
 
     // reset the game board if R is pressed
     if (event.key.code == sf::Keyboard::R) {
-        model.reset();
+        simulation.send([this]() { model.reset(); });
     } // if
 
 } // on_key_press()
@@ -57,17 +87,21 @@ void ControllerAllele::on_key_press(const sf::Event &event) {
 // mouse
 void ControllerAllele::update_geno() {
     sf::Vector2i mouse_pos = sf::Mouse::getPosition(window);
-    mouse_pos.x = static_cast<int>(mouse_pos.x * static_cast<double>(width) /
-                                   window.getSize().x);
-    mouse_pos.y = static_cast<int>(mouse_pos.y * static_cast<double>(height) /
-                                   window.getSize().y);
-    std::string geno = model.get_geno(static_cast<unsigned int>(mouse_pos.x),
-                                      static_cast<unsigned int>(mouse_pos.y));
-    geno += " (";
-    geno += std::to_string(mouse_pos.x);
-    geno += ", ";
-    geno += std::to_string(mouse_pos.y);
-    geno += ")";
+    sf::Vector2i cell = view.cell_at(mouse_pos.x, mouse_pos.y);
+    // read from the frame shown, since the model may be mid-generation; a
+    // mouse outside the window is off the board, which shows as an error
+    const Frame &frame = simulation.get_frame();
+    std::string geno = ModelAllele::genotype(
+            frame.alive, frame.dominant[0], frame.dominant[1],
+            static_cast<unsigned int>(cell.x),
+            static_cast<unsigned int>(cell.y));
+    if (cell.x >= 0) {
+        geno += " (";
+        geno += std::to_string(cell.x);
+        geno += ", ";
+        geno += std::to_string(cell.y);
+        geno += ")";
+    } // if
     view.update_title(geno);
 } // update_geno()
 
@@ -8,7 +8,9 @@
 
 #include "Controller.hpp"
 #include "ModelAllele.hpp"
+#include "Simulation.hpp"
 #include "ViewAllele.hpp"
+#include <cstdint>
 #include <stdio.h>
 
 namespace GameOfLife {
@@ -17,23 +19,40 @@ class ControllerAllele : public Controller {
 public:
     // construct an AlleleController
     ControllerAllele(unsigned int width, unsigned int height, double prob_alive,
-                     double dom_frequency, sf::RenderWindow &window,
-                     std::string output_file_name);
+                     double dom_frequency, const ModelOptions &options,
+                     sf::RenderWindow &window, std::string output_file_name);
     // display the view of the current board
     void display_view() override;
-    // update the underlying board
-    void update_model() override;
+    // step at the given delay or turbo level
+    void set_speed(double delay, unsigned int turbo) override;
     // handle key press events
     void on_key_press(const sf::Event &event) override;
     // update the titlebar to show the genotype of the cell currently under the
     // mouse
     void update_geno();
 
+protected:
+    // the view the board is drawn with
+    View &get_view() override {
+        return view;
+    }
+
 private:
+    // what the window is shown of the model
+    struct Frame {
+        BitGrid alive;
+        BitGrid dominant[2];
+        std::uint64_t generations;
+        bool is_recording;
+    };
+
     unsigned int width, height; // width and height of the board
     sf::RenderWindow &window;
     ViewAllele view;
     ModelAllele model;
+    // steps the model on a thread of its own; declared last, so the thread
+    // is stopped before the model is destroyed
+    Simulation<Frame> simulation;
 };
 
 } // namespace GameOfLife
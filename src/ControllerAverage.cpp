@@ -4,6 +4,7 @@
  */
 
 #include "ControllerAverage.hpp"
+#include <algorithm>
 
 namespace GameOfLife {
 
@@ -12,50 +13,88 @@ ControllerAverage::ControllerAverage(unsigned int width, unsigned int height,
                                      double prob_alive, bool sexual,
                                      double min_mutation, double max_mutation,
                                      unsigned int ideal_color,
+                                     const ModelOptions &options,
                                      sf::RenderWindow &window,
                                      std::string output_file_name)
-        : Controller(), view(width, height, window, output_file_name),
+        : Controller(), width(width), height(height),
+          view(width, height, window),
+          // the view learns of each generation from the frames it's shown,
+          // since the model is stepped on another thread
           model(width, height, prob_alive, sexual, min_mutation, max_mutation,
-                ideal_color, view),
-          red_change(0), green_change(0), blue_change(0) {
+                ideal_color, options, nullptr, output_file_name),
+          red_change(0), green_change(0), blue_change(0),
+          simulation(
+                  [this]() {
+                      ScopedPhase phase(&timers, PhaseTimers::STEP);
+                      model.update();
+                  },
+                  [this](Frame &frame) { publish_frame(frame); },
+                  Frame{std::vector<std::uint32_t>(
+                                static_cast<std::size_t>(width) * height),
+                        0, ideal_color, false}) {
+    model.set_timers(&timers);
+    view.set_timers(&timers);
+    simulation.start();
 } // ControllerAverage()
 
+// display the view of the current board
 void ControllerAverage::display_view() {
+    bool is_new = simulation.take_frame();
+    const Frame &frame = simulation.get_frame();
+    if (is_new) {
+        view.set_generations(frame.generations);
+        view.set_ideal_color(frame.ideal_color);
+        view.set_recording(frame.is_recording);
+    } // if
+    timers.tick(frame.generations,
+                static_cast<std::uint64_t>(width) * height);
+    view.render(GridView<std::uint32_t>(frame.colors.data(), width, height,
+                                        width));
     view.display();
 } // display_view()
 
-// update the game board if we aren't paused
-void ControllerAverage::update_model() {
-    if (!is_paused) {
-        model.update();
-    } // if
-} // update_model()
+// copy the model's latest board into a frame, on the simulation's thread
+void ControllerAverage::publish_frame(Frame &frame) {
+    GridView<std::uint32_t> colors = model.get_colors();
+    for (unsigned int row = 0; row < height; ++row) {
+        std::copy(colors.row_data(row), colors.row_data(row) + width,
+                  &frame.colors[static_cast<std::size_t>(row) * width]);
+    } // for
+    frame.generations = model.get_generations();
+    frame.ideal_color = model.get_ideal_color();
+    frame.is_recording = model.get_is_recording();
+} // publish_frame()
+
+// step at the given delay or turbo level
+void ControllerAverage::set_speed(double delay, unsigned int turbo) {
+    pace(simulation, delay, turbo);
+    view.set_turbo(turbo);
+} // set_speed()
 
 // respond to key presses
 void ControllerAverage::on_key_press(const sf::Event &event) {
     // toggle pause
     if (event.key.code == sf::Keyboard::P) {
         is_paused = !is_paused;
+        simulation.set_paused(is_paused);
     } // if
 
     // toggle whether we are recording data
     if (event.key.code == sf::Keyboard::N) {
-        view.toggle_recording();
-        model.toggle_recording();
+        simulation.send([this]() { model.toggle_recording(); });
     } // if
 
     // if we are paused, step through generations one by one
     if (is_paused && event.key.code == sf::Keyboard::U) {
-        model.update();
+        simulation.step_once();
     } // if
 
     // increase the red channel of the ideal color
     if (event.key.code == sf::Keyboard::A) {
         red_change += COLOR_DELTA;
         if (red_change >= 0x000001) {
-            model.increase_ideal_color(static_cast<int>(red_change), 0, 0);
+            change_ideal_color(static_cast<int>(red_change), 0, 0);
             red_change = 0;
-            model.update_stats();
         }
     } // if
 
@@ -63,9 +102,8 @@ void ControllerAverage::on_key_press(const sf::Event &event) {
     if (event.key.code == sf::Keyboard::Z) {
         red_change -= COLOR_DELTA;
         if (red_change <= -0x000001) {
-            model.increase_ideal_color(static_cast<int>(red_change), 0, 0);
+            change_ideal_color(static_cast<int>(red_change), 0, 0);
             red_change = 0;
-            model.update_stats();
         }
     } // if
 
@@ -73,9 +111,8 @@ void ControllerAverage::on_key_press(const sf::Event &event) {
     if (event.key.code == sf::Keyboard::S) {
         green_change += COLOR_DELTA;
         if (green_change >= 0x000001) {
-            model.increase_ideal_color(0, static_cast<int>(green_change), 0);
+            change_ideal_color(0, static_cast<int>(green_change), 0);
             green_change = 0;
-            model.update_stats();
         }
     } // if
 
@@ -83,9 +120,8 @@ void ControllerAverage::on_key_press(const sf::Event &event) {
     if (event.key.code == sf::Keyboard::X) {
         green_change -= COLOR_DELTA;
         if (green_change <= -0x000001) {
-            model.increase_ideal_color(0, static_cast<int>(green_change), 0);
+            change_ideal_color(0, static_cast<int>(green_change), 0);
             green_change = 0;
-            model.update_stats();
         }
     } // if
 
@@ -93,9 +129,8 @@ void ControllerAverage::on_key_press(const sf::Event &event) {
     if (event.key.code == sf::Keyboard::D) {
         blue_change += COLOR_DELTA;
         if (blue_change >= 0x000001) {
-            model.increase_ideal_color(0, 0, static_cast<int>(blue_change));
+            change_ideal_color(0, 0, static_cast<int>(blue_change));
             blue_change = 0;
-            model.update_stats();
         }
     } // if
 
@@ -103,40 +138,54 @@ void ControllerAverage::on_key_press(const sf::Event &event) {
     if (event.key.code == sf::Keyboard::C) {
         blue_change -= COLOR_DELTA;
         if (blue_change <= -0x000001) {
-            model.increase_ideal_color(0, 0, static_cast<int>(blue_change));
+            change_ideal_color(0, 0, static_cast<int>(blue_change));
             blue_change = 0;
-            model.update_stats();
         }
     } // if
 
     // set the ideal color to red
     if (event.key.code == sf::Keyboard::F) {
-        model.set_ideal_color(0xFF0000);
-        model.update_stats();
+        replace_ideal_color(0xFF0000);
     } // if
 
     // set the ideal color to white
     if (event.key.code == sf::Keyboard::G) {
-        model.set_ideal_color(0xFFFFFF);
-        model.update_stats();
+        replace_ideal_color(0xFFFFFF);
     } // if
 
     // set the ideal color to blue
     if (event.key.code == sf::Keyboard::H) {
-        model.set_ideal_color(0x0000FF);
-        model.update_stats();
+        replace_ideal_color(0x0000FF);
     } // if
 
     // reset the board
     if (event.key.code == sf::Keyboard::R) {
-        model.reset();
+        simulation.send([this]() { model.reset(); });
     } // if
 
 } // on_key_press()
 
 // set the ideal color used for determining fitness
 void ControllerAverage::set_ideal_color(int ideal_color) {
-    model.set_ideal_color(static_cast<unsigned int>(ideal_color));
+    simulation.send([this, ideal_color]() {
+        model.set_ideal_color(static_cast<unsigned int>(ideal_color));
+    });
 }
 
+// change the ideal color by the given amounts of red, green and blue
+void ControllerAverage::change_ideal_color(int red, int green, int blue) {
+    simulation.send([this, red, green, blue]() {
+        model.increase_ideal_color(red, green, blue);
+        model.update_stats();
+    });
+} // change_ideal_color()
+
+// change the ideal color to a new one
+void ControllerAverage::replace_ideal_color(unsigned int ideal_color) {
+    simulation.send([this, ideal_color]() {
+        model.set_ideal_color(ideal_color);
+        model.update_stats();
+    });
+} // replace_ideal_color()
+
 } // namespace GameOfLife
@@ -8,8 +8,11 @@
 
 #include "Controller.hpp"
 #include "ModelAverage.hpp"
+#include "Simulation.hpp"
 #include "ViewAverage.hpp"
+#include <cstdint>
 #include <stdio.h>
+#include <vector>
 
 namespace GameOfLife {
 
@@ -18,21 +21,49 @@ public:
     ControllerAverage(unsigned int width, unsigned int height,
                       double prob_alive, bool sexual, double min_mutation,
                       double max_mutation, unsigned int ideal_color,
-                      sf::RenderWindow &window, std::string output_file_name);
+                      const ModelOptions &options, sf::RenderWindow &window,
+                      std::string output_file_name);
     // display the view of the current board
     void display_view() override;
-    // update the game board if we aren't paused
-    void update_model() override;
+    // step at the given delay or turbo level
+    void set_speed(double delay, unsigned int turbo) override;
     // respond to key presses
     void on_key_press(const sf::Event &event) override;
     // set the ideal color used for determining fitness
     void set_ideal_color(int ideal_color);
 
+protected:
+    // the view the board is drawn with
+    View &get_view() override {
+        return view;
+    }
+
 private:
+    // what the window is shown of the model
+    struct Frame {
+        // the color of each cell, row by row
+        std::vector<std::uint32_t> colors;
+        std::uint64_t generations;
+        unsigned int ideal_color;
+        bool is_recording;
+    };
+
+    // copy the model's latest board into a frame, on the simulation's
+    // thread
+    void publish_frame(Frame &frame);
+    // change the ideal color by the given amounts of red, green and blue
+    void change_ideal_color(int red, int green, int blue);
+    // change the ideal color to a new one
+    void replace_ideal_color(unsigned int ideal_color);
+
+    unsigned int width, height; // width and height of the board
     ViewAverage view;
     ModelAverage model;
     static constexpr double COLOR_DELTA = 0x1;
     double red_change, green_change, blue_change;
+    // steps the model on a thread of its own; declared last, so the thread
+    // is stopped before the model is destroyed
+    Simulation<Frame> simulation;
 };
 
 } // namespace GameOfLife
@@ -12,38 +12,76 @@ namespace GameOfLife {
 
 ControllerDefault::ControllerDefault(unsigned int width, unsigned int height,
                                      double prob_alive,
-                                     sf::RenderWindow &window,
-                                     std::string output_file_name)
-        : Controller(), view(width, height, window, output_file_name),
-          model(width, height, prob_alive, view) {} // ControllerDefault()
+                                     const ModelOptions &options,
+                                     sf::RenderWindow &window)
+        : Controller(), view(width, height, window),
+          // the view learns of each generation from the frames it's shown,
+          // since the model is stepped on another thread
+          model(width, height, prob_alive, options, nullptr),
+          simulation(
+                  [this]() {
+                      ScopedPhase phase(&timers, PhaseTimers::STEP);
+                      model.update();
+                  },
+                  [this](Frame &frame) {
+                      frame.grid = model.get_grid();
+                      frame.generations = model.get_generations();
+                      frame.step_exponent = model.get_step_exponent();
+                      frame.fast_forward_error =
+                              model.get_fast_forward_error();
+                  },
+                  Frame{BitGrid(width, height), 0, 0, nullptr}) {
+    model.set_timers(&timers);
+    view.set_timers(&timers);
+    simulation.start();
+} // ControllerDefault()
 
 // display the current board state
 void ControllerDefault::display_view() {
+    bool is_new = simulation.take_frame();
+    const Frame &frame = simulation.get_frame();
+    if (is_new) {
+        view.set_generations(frame.generations);
+        view.set_step_exponent(frame.step_exponent);
+        view.set_fast_forward_error(frame.fast_forward_error);
+    } // if
+    timers.tick(frame.generations,
+                static_cast<std::uint64_t>(model.get_width()) *
+                        model.get_height());
+    view.render(frame.grid);
     view.display();
-}
+} // display_view()
 
-// update the underlying board
-void ControllerDefault::update_model() {
-    if (!is_paused) {
-        model.update();
-    } // if
-} // update_model()
+// step at the given delay or turbo level
+void ControllerDefault::set_speed(double delay, unsigned int turbo) {
+    pace(simulation, delay, turbo);
+    view.set_turbo(turbo);
+} // set_speed()
 
 // respond to key presses
 void ControllerDefault::on_key_press(const sf::Event &event) {
     // toggle pausinbg
     if (event.key.code == sf::Keyboard::P) {
         is_paused = !is_paused;
+        simulation.set_paused(is_paused);
     } // if
 
     // if we are paused, step through generations one by one
     if (is_paused && event.key.code == sf::Keyboard::U) {
-        model.update();
+        simulation.step_once();
+    } // if
+
+    // double / halve the number of generations per update
+    if (event.key.code == sf::Keyboard::Up) {
+        simulation.send([this]() { model.increase_step_exponent(1); });
+    } // if
+    if (event.key.code == sf::Keyboard::Down) {
+        simulation.send([this]() { model.increase_step_exponent(-1); });
     } // if
 
     // reset the game board
     if (event.key.code == sf::Keyboard::R) {
-        model.reset();
+        simulation.send([this]() { model.reset(); });
     } // if
 } // on_key_press()
 
@@ -11,7 +11,9 @@
 
 #include "Controller.hpp"
 #include "ModelDefault.hpp"
+#include "Simulation.hpp"
 #include "ViewDefault.hpp"
+#include <cstdint>
 #include <stdio.h>
 
 namespace GameOfLife {
@@ -19,18 +21,35 @@ namespace GameOfLife {
 class ControllerDefault : public Controller {
 public:
     ControllerDefault(unsigned int width, unsigned int height,
-                      double prob_alive, sf::RenderWindow &window,
-                      std::string output_file_name);
+                      double prob_alive, const ModelOptions &options,
+                      sf::RenderWindow &window);
     // display the current board state
     void display_view() override;
-    // update the underlying board
-    void update_model() override;
+    // step at the given delay or turbo level
+    void set_speed(double delay, unsigned int turbo) override;
     // respond to keyt presses
     void on_key_press(const sf::Event &event) override;
 
+protected:
+    // the view the board is drawn with
+    View &get_view() override {
+        return view;
+    }
+
 private:
+    // what the window is shown of the model
+    struct Frame {
+        BitGrid grid;
+        std::uint64_t generations;
+        unsigned int step_exponent;
+        const char *fast_forward_error;
+    };
+
     ViewDefault view;
     ModelDefault model;
+    // steps the model on a thread of its own; declared last, so the thread
+    // is stopped before the model is destroyed
+    Simulation<Frame> simulation;
 };
 
 } // namespace GameOfLife
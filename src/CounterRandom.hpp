@@ -0,0 +1,96 @@
+/*
+ * CounterRandom.hpp
+ * A counter-based random number generator (Philox4x32-10): every draw is a
+ * pure function of a key, a generation, a cell and the draw's index, so cells
+ * can be stepped in any order and any one of them replayed on its own.
+ */
+
+#ifndef CounterRandom_hpp
+#define CounterRandom_hpp
+
+#include <cstdint>
+#include <stdio.h>
+
+namespace GameOfLife {
+
+class CounterRandom {
+public:
+    // the random numbers of one cell in one generation of a board identified
+    // by key; nothing is computed until the first draw
+    CounterRandom(std::uint64_t key, std::uint64_t generation,
+                  std::uint32_t cell)
+            : key{static_cast<std::uint32_t>(key),
+                  static_cast<std::uint32_t>(key >> 32)},
+              counter{0, cell, static_cast<std::uint32_t>(generation),
+                      static_cast<std::uint32_t>(generation >> 32)},
+              block{0, 0, 0, 0}, used(BLOCK_SIZE) {}
+
+    // the next 32 random bits
+    std::uint32_t next() {
+        if (used == BLOCK_SIZE) {
+            philox(counter, key, block);
+            ++counter[0];
+            used = 0;
+        } // if
+        return block[used++];
+    }
+
+    // a uniform double in [0, 1) with 53 random bits
+    double uniform() {
+        std::uint64_t high = next();
+        std::uint64_t low = next();
+        return static_cast<double>(((high << 32) | low) >> 11) *
+               (1.0 / 9007199254740992.0);
+    }
+
+    // a uniform double in [min, max)
+    double uniform(double min, double max) {
+        return min + (max - min) * uniform();
+    }
+
+    // a fair coin flip, 0 or 1
+    unsigned int bit() {
+        return next() >> 31;
+    }
+
+    // ten rounds of Philox4x32 over counter with key, written to out
+    static void philox(const std::uint32_t counter[4],
+                       const std::uint32_t key[2], std::uint32_t out[4]) {
+        std::uint32_t c0 = counter[0], c1 = counter[1];
+        std::uint32_t c2 = counter[2], c3 = counter[3];
+        std::uint32_t k0 = key[0], k1 = key[1];
+        for (int round = 0; round < ROUNDS; ++round) {
+            std::uint64_t product0 = std::uint64_t{MULTIPLIER_0} * c0;
+            std::uint64_t product1 = std::uint64_t{MULTIPLIER_1} * c2;
+            std::uint32_t high0 = static_cast<std::uint32_t>(product0 >> 32);
+            std::uint32_t high1 = static_cast<std::uint32_t>(product1 >> 32);
+            c0 = high1 ^ c1 ^ k0;
+            c1 = static_cast<std::uint32_t>(product1);
+            c2 = high0 ^ c3 ^ k1;
+            c3 = static_cast<std::uint32_t>(product0);
+            k0 += WEYL_0;
+            k1 += WEYL_1;
+        } // for
+        out[0] = c0;
+        out[1] = c1;
+        out[2] = c2;
+        out[3] = c3;
+    }
+
+private:
+    std::uint32_t key[2];
+    // draw block, cell, generation low and high bits
+    std::uint32_t counter[4];
+    std::uint32_t block[4];
+    unsigned int used;
+
+    static constexpr unsigned int BLOCK_SIZE = 4;
+    static constexpr int ROUNDS = 10;
+    static constexpr std::uint32_t MULTIPLIER_0 = 0xD2511F53;
+    static constexpr std::uint32_t MULTIPLIER_1 = 0xCD9E8D57;
+    static constexpr std::uint32_t WEYL_0 = 0x9E3779B9;
+    static constexpr std::uint32_t WEYL_1 = 0xBB67AE85;
+};
+
+} // namespace GameOfLife
+#endif /* CounterRandom_hpp */
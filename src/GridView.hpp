@@ -0,0 +1,38 @@
+/*
+ * GridView.hpp
+ * A read-only window onto a board stored by a model, row by row with a
+ * stride, so callers can read its cells without copying them. It stays
+ * valid until the model is next stepped or reset.
+ */
+
+#ifndef GridView_hpp
+#define GridView_hpp
+
+#include <cstddef>
+#include <stdio.h>
+
+namespace GameOfLife {
+
+template <typename T>
+struct GridView {
+    GridView(const T *data, unsigned int width, unsigned int height,
+             std::size_t stride)
+            : data(data), width(width), height(height), stride(stride) {}
+
+    // the cell at (row, col)
+    const T &at(unsigned int row, unsigned int col) const {
+        return data[row * stride + col];
+    }
+    // the first cell of row
+    const T *row_data(unsigned int row) const {
+        return data + row * stride;
+    }
+
+    const T *data;
+    unsigned int width;
+    unsigned int height;
+    std::size_t stride; // elements from one row to the next
+};
+
+} // namespace GameOfLife
+#endif /* GridView_hpp */
@@ -0,0 +1,550 @@
+/*
+ * HashLife.cpp
+ * A hash-consed quadtree that fast-forwards a packed board by 2^k
+ * generations at a time, memoizing the future of every distinct block.
+ */
+
+#include "HashLife.hpp"
+#include <algorithm>
+
+namespace GameOfLife {
+
+// construct an empty universe holding at most max_nodes nodes
+HashLife::HashLife(const Rule &rule, std::size_t max_nodes)
+        : rule(rule), nodes(), table(std::size_t{1} << 16, 0), empties(),
+          clips(2), clip_index(), board_width(0), board_height(0),
+          max_nodes(max_nodes), step(0), longest_step(NONE),
+          last_root(NONE) {} // HashLife()
+
+std::size_t HashLife::hash_leaf(std::uint64_t bits) {
+    std::uint64_t hash = bits * 0x9E3779B97F4A7C15ULL;
+    return static_cast<std::size_t>(hash ^ (hash >> 32));
+} // hash_leaf()
+
+std::size_t HashLife::hash_children(const std::uint32_t child[4],
+                                    std::uint32_t clip) {
+    std::uint64_t hash = clip;
+    for (int i = 0; i < 4; ++i) {
+        hash = hash * 0x9E3779B97F4A7C15ULL + child[i];
+    } // for
+    return static_cast<std::size_t>(hash ^ (hash >> 29));
+} // hash_children()
+
+// insert a node that isn't in the hash table yet, throwing CacheFull if the
+// cache is already full
+std::uint32_t HashLife::insert(const Node &node, std::size_t hash) {
+    if (nodes.size() >= max_nodes) {
+        throw CacheFull();
+    } // if
+    if ((nodes.size() + 1) * 2 > table.size()) {
+        table.assign(table.size() * 2, 0);
+        rehash();
+    } // if
+    std::uint32_t index = static_cast<std::uint32_t>(nodes.size());
+    nodes.push_back(node);
+    std::size_t mask = table.size() - 1;
+    std::size_t slot = hash & mask;
+    while (table[slot] != 0) {
+        slot = (slot + 1) & mask;
+    } // while
+    table[slot] = index + 1;
+    return index;
+} // insert()
+
+// rebuild the hash table from the node list
+void HashLife::rehash() {
+    std::fill(table.begin(), table.end(), 0);
+    std::size_t mask = table.size() - 1;
+    for (std::uint32_t i = 0; i < nodes.size(); ++i) {
+        const Node &node = nodes[i];
+        std::size_t hash = node.level == LEAF_LEVEL
+                                   ? hash_leaf(node.bits)
+                                   : hash_children(node.child, node.clip);
+        std::size_t slot = hash & mask;
+        while (table[slot] != 0) {
+            slot = (slot + 1) & mask;
+        } // while
+        table[slot] = i + 1;
+    } // for
+} // rehash()
+
+// intern a leaf, reusing an identical existing one
+std::uint32_t HashLife::leaf(std::uint64_t bits) {
+    std::size_t hash = hash_leaf(bits);
+    std::size_t mask = table.size() - 1;
+    for (std::size_t slot = hash & mask; table[slot] != 0;
+         slot = (slot + 1) & mask) {
+        const Node &node = nodes[table[slot] - 1];
+        if (node.level == LEAF_LEVEL && node.bits == bits) {
+            return table[slot] - 1;
+        } // if
+    }     // for
+    Node node{{NONE, NONE, NONE, NONE},
+              bits,
+              static_cast<std::uint64_t>(__builtin_popcountll(bits)),
+              NONE,
+              LEAF_LEVEL,
+              WHOLE};
+    return insert(node, hash);
+} // leaf()
+
+// intern an internal node, reusing an identical existing one; dead blocks
+// are the same wherever they are, so their clip is WHOLE
+std::uint32_t HashLife::join(std::uint32_t nw, std::uint32_t ne,
+                             std::uint32_t sw, std::uint32_t se,
+                             std::uint32_t clip) {
+    std::uint64_t population = nodes[nw].population + nodes[ne].population +
+                               nodes[sw].population + nodes[se].population;
+    Node node{{nw, ne, sw, se},
+              0,
+              population,
+              NONE,
+              nodes[nw].level + 1,
+              population == 0 ? WHOLE : clip};
+    std::size_t hash = hash_children(node.child, node.clip);
+    std::size_t mask = table.size() - 1;
+    for (std::size_t slot = hash & mask; table[slot] != 0;
+         slot = (slot + 1) & mask) {
+        const Node &other = nodes[table[slot] - 1];
+        if (other.level == node.level && other.clip == node.clip &&
+            std::equal(node.child, node.child + 4, other.child)) {
+            return table[slot] - 1;
+        } // if
+    }     // for
+    return insert(node, hash);
+} // join()
+
+// the clip of a 2^level block covering the given cells of a board
+std::uint32_t HashLife::board_clip(std::uint32_t level, long long row,
+                                   long long col) {
+    return intern_clip(level, -col, -row, board_width - col,
+                       board_height - row);
+} // board_clip()
+
+// the clip of the 2^level block at (row, col) inside a block clipped to clip
+std::uint32_t HashLife::sub_clip(std::uint32_t clip, std::uint32_t level,
+                                 long long row, long long col) {
+    if (clip == WHOLE || clip == OUTSIDE) {
+        return clip;
+    } // if
+    Clip outer = clips[clip];
+    return intern_clip(level, outer.left - col, outer.top - row,
+                       outer.right - col, outer.bottom - row);
+} // sub_clip()
+
+// intern the part of a 2^level block from left, top to right, bottom
+std::uint32_t HashLife::intern_clip(std::uint32_t level, long long left,
+                                    long long top, long long right,
+                                    long long bottom) {
+    long long size = 1LL << level;
+    left = std::max(left, 0LL);
+    top = std::max(top, 0LL);
+    right = std::min(right, size);
+    bottom = std::min(bottom, size);
+    if (left >= right || top >= bottom) {
+        return OUTSIDE;
+    } // if
+    if (left == 0 && top == 0 && right == size && bottom == size) {
+        return WHOLE;
+    } // if
+    std::array<long long, 4> key = {{left, top, right, bottom}};
+    auto found = clip_index.find(key);
+    if (found != clip_index.end()) {
+        return found->second;
+    } // if
+    std::uint32_t clip = static_cast<std::uint32_t>(clips.size());
+    clips.push_back(Clip{left, top, right, bottom});
+    clip_index.emplace(key, clip);
+    return clip;
+} // intern_clip()
+
+// the all-dead node of a level
+std::uint32_t HashLife::empty(std::uint32_t level) {
+    if (empties.size() <= level) {
+        empties.resize(level + 1, NONE);
+    } // if
+    if (empties[level] == NONE) {
+        std::uint32_t node;
+        if (level == LEAF_LEVEL) {
+            node = leaf(0);
+        } else {
+            std::uint32_t child = empty(level - 1);
+            node = join(child, child, child, child, WHOLE);
+        } // if/else
+        empties[level] = node;
+    } // if
+    return empties[level];
+} // empty()
+
+// lay the four leaves of a 16x16 node out as 16 rows of 16 cells
+static void leaf_rows(std::uint64_t nw, std::uint64_t ne, std::uint64_t sw,
+                      std::uint64_t se, std::uint64_t rows[16]) {
+    for (unsigned int row = 0; row < 8; ++row) {
+        unsigned int shift = row * 8;
+        rows[row] = ((nw >> shift) & 0xFF) | (((ne >> shift) & 0xFF) << 8);
+        rows[row + 8] = ((sw >> shift) & 0xFF) | (((se >> shift) & 0xFF) << 8);
+    } // for
+} // leaf_rows()
+
+// pack the center 8x8 cells of 16 rows of 16 cells into a leaf
+static std::uint64_t center_bits(const std::uint64_t rows[16]) {
+    std::uint64_t bits = 0;
+    for (unsigned int row = 0; row < 8; ++row) {
+        bits |= ((rows[row + 4] >> 4) & 0xFF) << (row * 8);
+    } // for
+    return bits;
+} // center_bits()
+
+// the center half of a node, not advanced in time
+std::uint32_t HashLife::center(std::uint32_t index) {
+    Node node = nodes[index];
+    Node nw = nodes[node.child[0]], ne = nodes[node.child[1]];
+    Node sw = nodes[node.child[2]], se = nodes[node.child[3]];
+    if (node.level == LEAF_LEVEL + 1) {
+        std::uint64_t rows[16];
+        leaf_rows(nw.bits, ne.bits, sw.bits, se.bits, rows);
+        return leaf(center_bits(rows));
+    } // if
+    long long quarter = 1LL << (node.level - 2);
+    return join(nw.child[3], ne.child[2], sw.child[1], se.child[0],
+                sub_clip(node.clip, node.level - 1, quarter, quarter));
+} // center()
+
+// the center of a 16x16 node, stepped directly on its bits
+std::uint32_t HashLife::base_result(const Node &node) {
+    std::uint64_t block[16];
+    leaf_rows(nodes[node.child[0]].bits, nodes[node.child[1]].bits,
+              nodes[node.child[2]].bits, nodes[node.child[3]].bits, block);
+    // a row of zeros above and below the block, and a word of zeros on either
+    // side of each row
+    std::uint64_t rows[18][3] = {};
+    for (unsigned int row = 0; row < 16; ++row) {
+        rows[row + 1][1] = block[row];
+    } // for
+    // the cells of each row on the board, which are all that may live
+    std::uint64_t on_board[16];
+    std::fill(on_board, on_board + 16, std::uint64_t{0xFFFF});
+    if (node.clip != WHOLE) {
+        const Clip &clip = clips[node.clip];
+        std::uint64_t width = std::uint64_t{1} << (clip.right - clip.left);
+        std::uint64_t cols = (width - 1) << clip.left;
+        for (unsigned int row = 0; row < 16; ++row) {
+            on_board[row] = row >= clip.top && row < clip.bottom ? cols : 0;
+        } // for
+    } // if
+    // errors from the dead cells assumed past the edges creep in one cell
+    // per generation, so the center stays exact for up to four
+    unsigned int generations = 1u << std::min(step, 2u);
+    for (unsigned int gen = 0; gen < generations; ++gen) {
+        std::uint64_t next[18][3] = {};
+        for (unsigned int row = 1; row <= 16; ++row) {
+            BitGrid::NeighborCount count = BitGrid::count_neighbors(
+                    &rows[row - 1][1], &rows[row][1], &rows[row + 1][1], 0);
+            next[row][1] = BitGrid::next_state(count, rows[row][1], rule) &
+                           on_board[row - 1];
+        } // for
+        std::copy(&next[0][0], &next[0][0] + 18 * 3, &rows[0][0]);
+    } // for
+    for (unsigned int row = 0; row < 16; ++row) {
+        block[row] = rows[row + 1][1];
+    } // for
+    return leaf(center_bits(block));
+} // base_result()
+
+// the center half of a node, advanced 2^min(step, level - 2) generations
+std::uint32_t HashLife::result(std::uint32_t index) {
+    Node node = nodes[index];
+    if (node.result != NONE) {
+        return node.result;
+    } // if
+
+    std::uint32_t out;
+    if (node.population == 0) {
+        out = empty(node.level - 1);
+    } else if (node.level == LEAF_LEVEL + 1) {
+        out = base_result(node);
+    } else {
+        Node nw = nodes[node.child[0]], ne = nodes[node.child[1]];
+        Node sw = nodes[node.child[2]], se = nodes[node.child[3]];
+
+        // nine overlapping sub-blocks, each half the size of this node and
+        // a quarter of it apart
+        std::uint32_t half = node.level - 1;
+        long long quarter = 1LL << (node.level - 2);
+        auto clip_at = [&](long long row, long long col) {
+            return sub_clip(node.clip, half, row * quarter, col * quarter);
+        };
+        std::uint32_t sub[9] = {
+                node.child[0],
+                join(nw.child[1], ne.child[0], nw.child[3], ne.child[2],
+                     clip_at(0, 1)),
+                node.child[1],
+                join(nw.child[2], nw.child[3], sw.child[0], sw.child[1],
+                     clip_at(1, 0)),
+                join(nw.child[3], ne.child[2], sw.child[1], se.child[0],
+                     clip_at(1, 1)),
+                join(ne.child[2], ne.child[3], se.child[0], se.child[1],
+                     clip_at(1, 2)),
+                node.child[2],
+                join(sw.child[1], se.child[0], sw.child[3], se.child[2],
+                     clip_at(2, 1)),
+                node.child[3]};
+        for (std::uint32_t &block : sub) {
+            block = result(block);
+        } // for
+
+        // four half-size blocks from the stepped sub-blocks, whose centers
+        // start an eighth of this node in
+        auto eighth_clip_at = [&](long long row, long long col) {
+            return sub_clip(node.clip, half, (2 * row + 1) * quarter / 2,
+                            (2 * col + 1) * quarter / 2);
+        };
+        std::uint32_t quad[4] = {
+                join(sub[0], sub[1], sub[3], sub[4], eighth_clip_at(0, 0)),
+                join(sub[1], sub[2], sub[4], sub[5], eighth_clip_at(0, 1)),
+                join(sub[3], sub[4], sub[6], sub[7], eighth_clip_at(1, 0)),
+                join(sub[4], sub[5], sub[7], sub[8], eighth_clip_at(1, 1))};
+        // step them again for the full 2^(level - 2) generations, or just
+        // take their centers if the step is shorter
+        bool full_step = step >= node.level - 2;
+        for (std::uint32_t &block : quad) {
+            block = full_step ? result(block) : center(block);
+        } // for
+        out = join(quad[0], quad[1], quad[2], quad[3], clip_at(1, 1));
+    } // if/else
+
+    nodes[index].result = out;
+    return out;
+} // result()
+
+// copy the board into a new node of the given level
+std::uint32_t HashLife::build(const BitGrid &grid, std::uint32_t level,
+                              long long row, long long col) {
+    if (row >= grid.get_height() || col >= grid.get_width()) {
+        return empty(level);
+    } // if
+    if (level == LEAF_LEVEL) {
+        std::uint64_t bits = 0;
+        for (unsigned int r = 0; r < LEAF_SIZE && row + r < grid.get_height();
+             ++r) {
+            std::uint64_t word = grid.row_data(static_cast<unsigned int>(
+                    row + r))[col / BitGrid::WORD_BITS];
+            bits |= ((word >> (col % BitGrid::WORD_BITS)) & 0xFF) << (r * 8);
+        } // for
+        return leaf(bits);
+    } // if
+    long long half = 1LL << (level - 1);
+    std::uint32_t nw = build(grid, level - 1, row, col);
+    std::uint32_t ne = build(grid, level - 1, row, col + half);
+    std::uint32_t sw = build(grid, level - 1, row + half, col);
+    std::uint32_t se = build(grid, level - 1, row + half, col + half);
+    return join(nw, ne, sw, se, board_clip(level, row, col));
+} // build()
+
+// copy the cells of node that lie on the board back into grid
+void HashLife::write(BitGrid &grid, std::uint32_t index, long long row,
+                     long long col) {
+    const Node &node = nodes[index];
+    long long size = 1LL << node.level;
+    if (node.population == 0 || row >= grid.get_height() ||
+        col >= grid.get_width() || row + size <= 0 || col + size <= 0) {
+        return;
+    } // if
+    if (node.level == LEAF_LEVEL) {
+        // leaves always start on a byte boundary of the packed rows
+        std::uint64_t bits = node.bits;
+        for (unsigned int r = 0; r < LEAF_SIZE; ++r) {
+            long long current = row + r;
+            if (current < 0 || current >= grid.get_height()) {
+                continue;
+            } // if
+            grid.row_data(static_cast<unsigned int>(
+                    current))[col / BitGrid::WORD_BITS] |=
+                    ((bits >> (r * 8)) & 0xFF) << (col % BitGrid::WORD_BITS);
+        } // for
+        return;
+    } // if
+    std::uint32_t child[4];
+    std::copy(node.child, node.child + 4, child);
+    long long half = size / 2;
+    write(grid, child[0], row, col);
+    write(grid, child[1], row, col + half);
+    write(grid, child[2], row + half, col);
+    write(grid, child[3], row + half, col + half);
+} // write()
+
+// drop every node unreachable from keep, then the cached results if that
+// doesn't free enough space, then every node if that doesn't either
+void HashLife::collect(std::uint32_t keep) {
+    keep = compact(keep, true);
+    if (nodes.size() > max_nodes / 2) {
+        for (Node &node : nodes) {
+            node.result = NONE;
+        } // for
+        compact(keep, false);
+    } // if
+    if (nodes.size() > max_nodes / 2) {
+        nodes.clear();
+    } // if
+    empties.clear();
+    last_root = NONE;
+    rehash();
+} // collect()
+
+// drop every node unreachable from keep through its children, and its cached
+// results if follow_results is set, returning keep's new index
+std::uint32_t HashLife::compact(std::uint32_t keep, bool follow_results) {
+    std::vector<std::uint32_t> remap(nodes.size(), NONE);
+    if (keep != NONE) {
+        std::vector<std::uint32_t> stack{keep};
+        remap[keep] = 0;
+        while (!stack.empty()) {
+            const Node &node = nodes[stack.back()];
+            stack.pop_back();
+            std::uint32_t next[5] = {NONE, NONE, NONE, NONE,
+                                     follow_results ? node.result : NONE};
+            if (node.level > LEAF_LEVEL) {
+                std::copy(node.child, node.child + 4, next);
+            } // if
+            for (std::uint32_t index : next) {
+                if (index != NONE && remap[index] == NONE) {
+                    remap[index] = 0;
+                    stack.push_back(index);
+                } // if
+            }     // for
+        }         // while
+    }             // if
+
+    // compact the survivors, which keeps children ahead of their parents
+    std::uint32_t kept = 0;
+    for (std::uint32_t i = 0; i < nodes.size(); ++i) {
+        if (remap[i] != NONE) {
+            remap[i] = kept;
+            nodes[kept++] = nodes[i];
+        } // if
+    }     // for
+    nodes.resize(kept);
+    for (Node &node : nodes) {
+        if (node.level > LEAF_LEVEL) {
+            for (std::uint32_t &child : node.child) {
+                child = remap[child];
+            } // for
+        }     // if
+        if (node.result != NONE) {
+            node.result = remap[node.result];
+        } // if
+    }     // for
+    return keep != NONE ? remap[keep] : NONE;
+} // compact()
+
+// advance grid by 2^step_exponent generations in place, treating everything
+// off the board as dead and dropping cells that leave it; returns the number
+// of generations advanced, which falls short only if even a single
+// generation of the board needs more than max_nodes nodes
+std::uint64_t HashLife::advance(BitGrid &grid, unsigned int step_exponent) {
+    // a board that has settled down may fit a longer step than last time
+    if (longest_step < step_exponent) {
+        ++longest_step;
+    } // if
+    return advance_in_halves(grid, step_exponent);
+} // advance()
+
+// advance grid by 2^step_exponent generations, split into halves for as long
+// as the cache can't hold the whole step
+std::uint64_t HashLife::advance_in_halves(BitGrid &grid,
+                                          unsigned int step_exponent) {
+    if (step_exponent <= longest_step) {
+        Outcome outcome = try_advance(grid, step_exponent);
+        if (outcome == ADVANCED) {
+            return std::uint64_t{1} << step_exponent;
+        } // if
+        if (outcome == BOARD_TOO_LARGE || step_exponent == 0) {
+            return 0;
+        } // if
+        longest_step = step_exponent - 1;
+    } // if
+    std::uint64_t half = std::uint64_t{1} << (step_exponent - 1);
+    std::uint64_t advanced = advance_in_halves(grid, step_exponent - 1);
+    if (advanced == half) {
+        advanced += advance_in_halves(grid, step_exponent - 1);
+    } // if
+    return advanced;
+} // advance_in_halves()
+
+// advance grid by the whole step at once, flushing the cache and trying again
+// if it fills up part way through
+HashLife::Outcome HashLife::try_advance(BitGrid &grid,
+                                        unsigned int step_exponent) {
+    if (step_exponent != step) {
+        // cached results are only valid for the step they were made with
+        for (Node &node : nodes) {
+            node.result = NONE;
+        } // for
+        step = step_exponent;
+    } // if
+    // leave half of the cache free for the step
+    if (nodes.size() > max_nodes / 2) {
+        collect(last_root);
+    } // if
+
+    board_width = grid.get_width();
+    board_height = grid.get_height();
+    while (true) {
+        bool was_empty = nodes.empty();
+        bool built = false;
+        try {
+            // the smallest block covering the board, with the board in the
+            // corner
+            std::uint32_t level = LEAF_LEVEL + 1;
+            while ((1u << level) <
+                   std::max(grid.get_width(), grid.get_height())) {
+                ++level;
+            } // while
+            std::uint32_t root = build(grid, level, 0, 0);
+            built = true;
+
+            // pad with dead cells until the root's result covers the board
+            // and is advanced by the full step
+            long long offset = 0;
+            do {
+                Node node = nodes[root];
+                std::uint32_t dead = empty(node.level - 1);
+                long long half = 1LL << (node.level - 1);
+                long long before = offset - half, after = offset + half;
+                std::uint32_t padded_nw =
+                        join(dead, dead, dead, node.child[0],
+                             board_clip(node.level, before, before));
+                std::uint32_t padded_ne =
+                        join(dead, dead, node.child[1], dead,
+                             board_clip(node.level, before, after));
+                std::uint32_t padded_sw =
+                        join(dead, node.child[2], dead, dead,
+                             board_clip(node.level, after, before));
+                std::uint32_t padded_se =
+                        join(node.child[3], dead, dead, dead,
+                             board_clip(node.level, after, after));
+                offset = before;
+                root = join(padded_nw, padded_ne, padded_sw, padded_se,
+                            board_clip(node.level + 1, offset, offset));
+            } while (nodes[root].level < step + 2);
+
+            std::uint32_t future = result(root);
+            last_root = root;
+            offset += 1LL << (nodes[root].level - 2);
+
+            grid.clear();
+            write(grid, future, offset, offset);
+            grid.clear_padding();
+            return ADVANCED;
+        } catch (const CacheFull &) {
+            // the nodes on the recursion path can't be told apart from the
+            // rest, so start the step over with nothing cached
+            collect(NONE);
+            if (was_empty) {
+                return built ? STEP_TOO_LONG : BOARD_TOO_LARGE;
+            } // if
+        } // try/catch
+    } // while
+} // try_advance()
+
+} // namespace GameOfLife
@@ -0,0 +1,147 @@
+/*
+ * HashLife.hpp
+ * A hash-consed quadtree that fast-forwards a packed board by 2^k
+ * generations at a time, memoizing the future of every distinct block.
+ * Blocks that cross the board's edge also remember which part of them is on
+ * the board, and cells off it are killed every generation, so only blocks
+ * along the edge are told apart by where they are.
+ */
+
+#ifndef HashLife_hpp
+#define HashLife_hpp
+
+#include "BitGrid.hpp"
+#include <array>
+#include <cstdint>
+#include <map>
+#include <stdio.h>
+#include <vector>
+
+namespace GameOfLife {
+
+class HashLife {
+public:
+    // construct an empty universe following a deterministic rule without B0,
+    // holding at most max_nodes nodes
+    explicit HashLife(const Rule &rule,
+                      std::size_t max_nodes = DEFAULT_MAX_NODES);
+
+    // advance grid by 2^step_exponent generations in place, exactly as
+    // stepping it a generation at a time with dead cells all around it would;
+    // returns the number of generations advanced, which falls short only if
+    // even a single generation of the board needs more than max_nodes nodes
+    std::uint64_t advance(BitGrid &grid, unsigned int step_exponent);
+
+    // the number of nodes currently cached
+    std::size_t size() const {
+        return nodes.size();
+    }
+
+    static constexpr std::size_t DEFAULT_MAX_NODES = std::size_t{1} << 22;
+
+private:
+    // how an attempt to advance the board went
+    enum Outcome { ADVANCED, STEP_TOO_LONG, BOARD_TOO_LARGE };
+    // thrown by insert() once max_nodes nodes are cached
+    struct CacheFull {};
+
+    // a square block of 2^level cells on a side; level 3 blocks are leaves
+    // holding their 8x8 cells directly, one byte per row
+    struct Node {
+        std::uint32_t child[4]; // nw, ne, sw, se
+        std::uint64_t bits;     // cells of a leaf
+        std::uint64_t population;
+        std::uint32_t result; // cached center after stepping, or NONE
+        std::uint32_t level;
+        std::uint32_t clip; // the part of the block on the board
+    };
+    // the cells [left, right) x [top, bottom) of a block that are on the
+    // board, counted from the block's top left corner
+    struct Clip {
+        long long left, top, right, bottom;
+    };
+
+    // intern a leaf / an internal node, reusing an identical existing one;
+    // dead blocks are the same wherever they are, so their clip is WHOLE
+    std::uint32_t leaf(std::uint64_t bits);
+    std::uint32_t join(std::uint32_t nw, std::uint32_t ne, std::uint32_t sw,
+                       std::uint32_t se, std::uint32_t clip);
+    // insert a node that isn't in the hash table yet, throwing CacheFull if
+    // the cache is already full
+    std::uint32_t insert(const Node &node, std::size_t hash);
+    // the all-dead node of a level
+    std::uint32_t empty(std::uint32_t level);
+
+    // the clip of a 2^level block covering the given cells of a board, or
+    // of the block at (row, col) inside a block clipped to clip
+    std::uint32_t board_clip(std::uint32_t level, long long row,
+                             long long col);
+    std::uint32_t sub_clip(std::uint32_t clip, std::uint32_t level,
+                           long long row, long long col);
+    // intern the part of a 2^level block from left, top to right, bottom
+    std::uint32_t intern_clip(std::uint32_t level, long long left,
+                              long long top, long long right,
+                              long long bottom);
+
+    // the center half of a node, not advanced in time
+    std::uint32_t center(std::uint32_t node);
+    // the center half of a node, advanced 2^min(step, level - 2) generations
+    std::uint32_t result(std::uint32_t node);
+    // the center of a 16x16 node, stepped directly on its bits
+    std::uint32_t base_result(const Node &node);
+
+    // copy the board into a new node of the given level
+    std::uint32_t build(const BitGrid &grid, std::uint32_t level,
+                        long long row, long long col);
+    // copy the cells of node that lie on the board back into grid
+    void write(BitGrid &grid, std::uint32_t node, long long row,
+               long long col);
+
+    // advance grid by 2^step_exponent generations, split into halves for as
+    // long as the cache can't hold the whole step
+    std::uint64_t advance_in_halves(BitGrid &grid, unsigned int step_exponent);
+    // advance grid by the whole step at once, flushing the cache and trying
+    // again if it fills up part way through
+    Outcome try_advance(BitGrid &grid, unsigned int step_exponent);
+
+    // drop every node unreachable from keep, then the cached results if
+    // that doesn't free enough space, then every node if that doesn't either
+    void collect(std::uint32_t keep);
+    // drop every node unreachable from keep through its children, and its
+    // cached results if follow_results is set, returning keep's new index
+    std::uint32_t compact(std::uint32_t keep, bool follow_results);
+    // rebuild the hash table from the node list
+    void rehash();
+
+    static std::size_t hash_leaf(std::uint64_t bits);
+    static std::size_t hash_children(const std::uint32_t child[4],
+                                     std::uint32_t clip);
+
+    Rule rule;
+    std::vector<Node> nodes;
+    // open-addressed table of node index + 1, zero when the slot is free
+    std::vector<std::uint32_t> table;
+    std::vector<std::uint32_t> empties;
+    // every distinct clip that isn't WHOLE or OUTSIDE, and where to find it
+    std::vector<Clip> clips;
+    std::map<std::array<long long, 4>, std::uint32_t> clip_index;
+    // the size of the board being advanced
+    long long board_width, board_height;
+
+    // the most nodes cached at once, half of which are kept between steps
+    std::size_t max_nodes;
+    unsigned int step;
+    // the longest step, as an exponent, that fit in the cache last time
+    unsigned int longest_step;
+    std::uint32_t last_root;
+
+    static constexpr std::uint32_t NONE = 0xFFFFFFFF;
+    // the clips of blocks wholly on and wholly off the board
+    static constexpr std::uint32_t WHOLE = 0;
+    static constexpr std::uint32_t OUTSIDE = 1;
+    static constexpr std::uint32_t LEAF_LEVEL = 3;
+    static constexpr std::uint32_t LEAF_SIZE = 8;
+};
+
+} // namespace GameOfLife
+#endif /* HashLife_hpp */
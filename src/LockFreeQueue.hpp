@@ -0,0 +1,58 @@
+/*
+ * LockFreeQueue.hpp
+ * A fixed-size queue between one thread that pushes and one that pops,
+ * neither of which ever waits on a lock: each end only moves its own
+ * index, and publishes it once the slot behind it is ready.
+ */
+
+#ifndef LockFreeQueue_hpp
+#define LockFreeQueue_hpp
+
+#include <atomic>
+#include <cstddef>
+#include <stdio.h>
+#include <utility>
+
+namespace GameOfLife {
+
+template <typename T, std::size_t Capacity>
+class LockFreeQueue {
+public:
+    LockFreeQueue() : head(0), tail(0), slots() {}
+
+    // add an item at the back, returning false if the queue is full;
+    // only ever called by the pushing thread
+    bool push(T item) {
+        std::size_t back = tail.load(std::memory_order_relaxed);
+        std::size_t next = (back + 1) % Capacity;
+        if (next == head.load(std::memory_order_acquire)) {
+            return false;
+        } // if
+        slots[back] = std::move(item);
+        tail.store(next, std::memory_order_release);
+        return true;
+    }
+    // take the item at the front into item, returning false if the queue is
+    // empty; only ever called by the popping thread
+    bool pop(T &item) {
+        std::size_t front = head.load(std::memory_order_relaxed);
+        if (front == tail.load(std::memory_order_acquire)) {
+            return false;
+        } // if
+        item = std::move(slots[front]);
+        slots[front] = T();
+        head.store((front + 1) % Capacity, std::memory_order_release);
+        return true;
+    }
+
+private:
+    // the next slot to pop and the next to push; one slot always stays
+    // empty, so a full queue can be told from an empty one. Each index sits
+    // on a cache line of its own, since each is written by its own thread
+    alignas(64) std::atomic<std::size_t> head;
+    alignas(64) std::atomic<std::size_t> tail;
+    T slots[Capacity];
+};
+
+} // namespace GameOfLife
+#endif /* LockFreeQueue_hpp */
@@ -6,7 +6,12 @@
 #ifndef Model_hpp
 #define Model_hpp
 
-#include "View.hpp"
+#include "Canvas.hpp"
+#include "CounterRandom.hpp"
+#include "PhaseTimers.hpp"
+#include "Rule.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
 #include <cstdint>
 #include <random>
 #include <stdio.h>
@@ -15,20 +20,35 @@
 
 namespace GameOfLife {
 
+// settings shared by every game mode
+struct ModelOptions {
+    ModelOptions()
+            : seed(std::random_device{}()), threads(0), rule(),
+              toroidal(false) {}
+
+    // runs with the same seed produce the same boards and statistics
+    std::uint64_t seed;
+    // threads to step the board with, or zero for one per hardware thread
+    unsigned int threads;
+    // rule in B/S notation, or empty for the game mode's own
+    std::string rule;
+    // whether the board wraps around at the edges instead of being bordered
+    // by dead cells
+    bool toroidal;
+};
+
 class Model {
 public:
-    Model(unsigned int width, unsigned int height, double prob_alive)
-            : rng(), width(width), height(height), generations(0u),
-              num_alive(0), prob_alive(prob_alive), is_recording(false) {
-        // seed random number generator
-        std::random_device rand_dev;
-        rng.seed(rand_dev());
-    } // Model()
-
-    // toggle recording on/off
-    void toggle_recording() {
-        is_recording = !is_recording;
-    }
+    // construct a model that tells canvas whenever its board changes, or
+    // nobody if canvas is null
+    Model(unsigned int width, unsigned int height, double prob_alive,
+          const ModelOptions &options, const std::string &default_rule,
+          Canvas *canvas)
+            : canvas(canvas), timers(nullptr), rng(), pool(options.threads),
+              rule(options.rule.empty() ? default_rule : options.rule),
+              toroidal(options.toroidal), width(width), height(height),
+              generations(0u), num_alive(0), prob_alive(prob_alive),
+              seed(options.seed), resets(0), board_key(0) {}
 
     // update the model if needed
     virtual void update() = 0;
@@ -36,18 +56,116 @@ public:
     // reset the whole game
     virtual void reset() = 0;
 
+    virtual ~Model() {}
+
+    // the number of generations since the board was filled
+    std::uint64_t get_generations() const {
+        return generations;
+    }
+    unsigned int get_width() const {
+        return width;
+    }
+    unsigned int get_height() const {
+        return height;
+    }
+    // the number of living cells on the latest board
+    unsigned int get_num_alive() const {
+        return num_alive;
+    }
+    // whether every cell is dead and none can ever be born again
+    bool is_extinct() const {
+        return num_alive == 0 && !rule.births_without_neighbors();
+    }
+    // time computing and recording statistics with timers, or not at all if
+    // timers is null
+    void set_timers(PhaseTimers *timers_) {
+        timers = timers_;
+    }
+
 protected:
+    // start the random numbers of a new board; every reset gets its own
+    void seed_board() {
+        ++resets;
+        board_key = make_board_key(0);
+        seed_fill(rng, board_key);
+    }
+    // the key of the random numbers of the current board of a model seeded
+    // offset higher, for stepping such boards side by side
+    std::uint64_t make_board_key(std::uint64_t offset) const {
+        // splitmix64 finalizer over the seed and the number of resets
+        std::uint64_t mix =
+                (seed + offset) ^ (resets * 0x9E3779B97F4A7C15ULL);
+        mix = (mix ^ (mix >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        mix = (mix ^ (mix >> 27)) * 0x94D049BB133111EBULL;
+        return mix ^ (mix >> 31);
+    }
+    // start a random stream for filling the board identified by key
+    static void seed_fill(std::minstd_rand &fill_rng, std::uint64_t key) {
+        // minstd_rand needs a seed in [1, 2^31 - 2]
+        std::uint64_t fill_seed = key % 2147483646ULL + 1;
+        fill_rng.seed(static_cast<std::uint_fast32_t>(fill_seed));
+    }
+
+    // the random numbers of the cell at position in this generation, which
+    // don't depend on the order or thread cells are stepped in
+    CounterRandom cell_random(unsigned int position) const {
+        return CounterRandom(board_key, generations, position);
+    }
+
+    // index of (row, col) in a board stored with a border of ghost cells
+    // around it, so every cell on the board has eight neighbors in memory
+    unsigned int padded_index(unsigned int row, unsigned int col) const {
+        return (row + 1) * (width + 2) + col + 1;
+    }
+    // the number of cells in a board with a border of ghost cells
+    std::size_t padded_size() const {
+        return static_cast<std::size_t>(width + 2) * (height + 2);
+    }
+    // copy the opposite edges of a board with a border of ghost cells into
+    // the ghost cells, so the board wraps around like a torus
+    template <typename T>
+    void wrap_halo(std::vector<T> &board) const {
+        unsigned int stride = width + 2;
+        for (unsigned int row = 0; row < height; ++row) {
+            unsigned int first = padded_index(row, 0);
+            unsigned int last = padded_index(row, width - 1);
+            board[first - 1] = board[last];
+            board[last + 1] = board[first];
+        } // for
+        // the last row above the first and the first below the last, corners
+        // included
+        std::copy(board.begin() + height * stride,
+                  board.begin() + (height + 1) * stride, board.begin());
+        std::copy(board.begin() + stride, board.begin() + 2 * stride,
+                  board.begin() + (height + 1) * stride);
+    }
+
+    // the key of the random numbers of the current board
+    std::uint64_t get_board_key() const {
+        return board_key;
+    }
+
+    Canvas *canvas;
+    PhaseTimers *timers;
+    // random stream for filling the board
     std::minstd_rand rng;
+    ThreadPool pool;
+    Rule rule;
+    bool toroidal;
 
     unsigned int width;
     unsigned int height;
-    unsigned int generations;
+    std::uint64_t generations;
     unsigned int num_alive;
     double prob_alive;
 
-    bool is_recording;
     static constexpr int IS_DEAD = 0x000000;
     static constexpr unsigned int IS_ALIVE = 0xFFFFFF;
+
+private:
+    std::uint64_t seed;
+    std::uint64_t resets;
+    std::uint64_t board_key;
 };
 
 } // namespace GameOfLife
@@ -4,34 +4,38 @@
  */
 
 #include "ModelAllele.hpp"
-#include "CellAllele.hpp"
+#include <initializer_list>
+#include <utility>
 
 namespace GameOfLife {
 
 // cosntruct a ModelAllele
 ModelAllele::ModelAllele(unsigned int width, unsigned int height,
                          double prob_alive, double dom_frequency,
-                         ViewAllele &view)
-        : Model(width, height, prob_alive), dom_frequency(dom_frequency),
-          view(view), num_recessive(0), num_dominant(0), num_recessive_pheno(0),
+                         const ModelOptions &options, Canvas *canvas,
+                         std::string output_file_name)
+        : Model(width, height, prob_alive, options, DEFAULT_RULE, canvas),
+          dom_frequency(dom_frequency),
+          recorder(output_file_name, STATS_HEADER),
+          current_grid(width, height), next_grid(width, height),
+          tiles(width, height, BitGrid::WORD_BITS, options.toroidal),
+          num_recessive(0), num_dominant(0), num_recessive_pheno(0),
           num_dominant_pheno(0) {
     reset();
 } // ModelAllele()
 
 // reset the game board
 void ModelAllele::reset() {
+    seed_board();
     generations = 0;
     num_alive = 0;
-    current_grid.clear();
-    current_grid.reserve(static_cast<std::size_t>(width * height));
-    next_grid.clear();
-    next_grid.reserve(static_cast<std::size_t>(width * height));
-    for (unsigned int row = 0; row < height; ++row) {
-        for (unsigned int col = 0; col < width; ++col) {
-            current_grid.emplace_back(row, col, 0, 0, this);
-            next_grid.emplace_back(row, col, 0, 0, this);
-        }
-    }
+    for (Planes *grid : {&current_grid, &next_grid}) {
+        grid->alive.clear();
+        grid->dominant[0].clear();
+        grid->dominant[1].clear();
+    } // for
+    tile_counts.assign(tiles.get_tile_count(), AlleleCounts());
+    tiles.activate_all();
     fill_grid();
 } // reset()
 
@@ -39,120 +43,277 @@ void ModelAllele::reset() {
 void ModelAllele::fill_grid() {
     // chance of a cell forming / having allel
     std::uniform_real_distribution<double> cells_chance(0.0, 1.0);
-    for (size_t pos = 0; pos < width * height; ++pos) {
-        double prob = cells_chance(rng);
-        // determine if the cell should be alive or dead
-        if (prob <= prob_alive) {
-            double allele_1_prob = cells_chance(rng);
-            double allele_2_prob = cells_chance(rng);
-            // randomly set the allele pair
-            next_grid[pos].allele_pair[0] =
-                    allele_1_prob <= dom_frequency ? DOMINANT : RECESSIVE;
-            next_grid[pos].allele_pair[1] =
-                    allele_2_prob <= dom_frequency ? DOMINANT : RECESSIVE;
-            next_grid[pos].update_color();
-            // update the view
-            view.update(static_cast<unsigned int>(pos),
-                        static_cast<int>(next_grid[pos].color), 0u);
-        } else {
-            next_grid[pos].color = IS_DEAD;
-            view.update(static_cast<unsigned int>(pos), IS_DEAD, 0u);
-        } // else
-    }     // for
+    for (unsigned int row = 0; row < height; ++row) {
+        for (unsigned int col = 0; col < width; ++col) {
+            double prob = cells_chance(rng);
+            // determine if the cell should be alive or dead
+            if (prob <= prob_alive) {
+                double allele_1_prob = cells_chance(rng);
+                double allele_2_prob = cells_chance(rng);
+                // randomly set the allele pair
+                bool dominant_1 = allele_1_prob <= dom_frequency;
+                bool dominant_2 = allele_2_prob <= dom_frequency;
+                next_grid.alive.set(row, col, true);
+                next_grid.dominant[0].set(row, col, dominant_1);
+                next_grid.dominant[1].set(row, col, dominant_2);
+            } // if
+        }     // for
+    }         // for
+    if (canvas != nullptr) {
+        canvas->set_generations(0u);
+    } // if
     // update all the board statistics
     update_stats();
+    wrap_halos();
 } // fill_grid()
 
 // calculate the frequency of dominant alleles
-double ModelAllele::calc_dominant_freq() {
+double ModelAllele::calc_dominant_freq() const {
     return static_cast<double>(num_dominant) /
            static_cast<double>(2 * num_alive);
 } // calc_dominant_freq()
 
 // calculate the frequency of recessive alleles
-double ModelAllele::calc_recessive_freq() {
+double ModelAllele::calc_recessive_freq() const {
     return static_cast<double>(num_recessive) /
            static_cast<double>(2 * num_alive);
 } // calc_recessive_freq()
 
 // calculate the frequency of phenotypically dominant cells
-double ModelAllele::calc_dominant_pheno() {
+double ModelAllele::calc_dominant_pheno() const {
     return static_cast<double>(num_dominant_pheno) /
            static_cast<double>(num_alive);
 } // calc_dominant_pheno()
 
 // calculate the frequency of phenotypically recessive cells
-double ModelAllele::calc_recessive_pheno() {
+double ModelAllele::calc_recessive_pheno() const {
     return static_cast<double>(num_recessive_pheno) /
            static_cast<double>(num_alive);
 } // calc_recessive_pheno()
 
 // update the board, swapping the current grid with the next grid
 void ModelAllele::update() {
-    current_grid.swap(next_grid);
+    // a tile left out keeps the same cells in both grids, since nothing near
+    // it changed last generation
+    std::swap(current_grid, next_grid);
     ++generations;
-    for (unsigned int i = 0; i < width * height; ++i) {
-        current_grid[i].update();
-    } // for
-    update_stats();
-    if (is_recording) {
-        view.write_data(calc_dominant_freq(), calc_recessive_freq(),
-                        calc_dominant_pheno(), calc_recessive_pheno());
+    // cells are counted while stepping, so the board is only swept once per
+    // generation
+    tiles.step_active(pool, [this](unsigned int tile_row, unsigned int word) {
+        return step_tile(tile_row, word);
+    });
+    {
+        ScopedPhase phase(timers, PhaseTimers::STATS);
+        merge_counts();
     }
+    if (canvas != nullptr) {
+        canvas->set_generations(generations);
+    } // if
+    wrap_halos();
+    if (recorder.get_is_recording()) {
+        std::string row;
+        {
+            ScopedPhase phase(timers, PhaseTimers::STATS);
+            row = format_stats();
+        }
+        ScopedPhase phase(timers, PhaseTimers::RECORD);
+        recorder.write_row(row);
+    } // if
 } // update()
 
-// update a cell at a given position to that of cell
-void ModelAllele::update_cell(unsigned int position, const CellAllele &cell) {
-    next_grid[position] = cell;
-    view.update(position, static_cast<int>(cell.color), generations);
-} // update_cell
+// the statistics of the latest board as a row of values under STATS_HEADER
+std::string ModelAllele::format_stats() const {
+    std::string row = std::to_string(generations);
+    row += ',';
+    row += std::to_string(calc_dominant_freq());
+    row += ',';
+    row += std::to_string(calc_recessive_freq());
+    row += ',';
+    row += std::to_string(calc_dominant_pheno());
+    row += ',';
+    row += std::to_string(calc_recessive_pheno());
+    return row;
+} // format_stats()
+
+// start recording the statistics of each generation to a new file, or stop
+void ModelAllele::toggle_recording() {
+    recorder.toggle_recording();
+} // toggle_recording()
+
+// step the cells of a tile, one word wide, into the next grid, counting them,
+// and return whether any changed or had a chance to
+bool ModelAllele::step_tile(unsigned int tile_row, unsigned int word) {
+    AlleleCounts &counts = tile_counts[tile_row * tiles.get_tile_cols() + word];
+    counts = AlleleCounts();
+    std::uint64_t changed = 0;
+    for (unsigned int row = tiles.row_begin(tile_row);
+         row < tiles.row_end(tile_row); ++row) {
+        changed |= step_word(row, word);
+        count_word(row, word, counts);
+    } // for
+    return changed != 0;
+} // step_tile()
+
+// step word of row into the next grid, returning the cells that changed or had
+// a chance to
+std::uint64_t ModelAllele::step_word(unsigned int row, unsigned int word) {
+    // the ghost rows stand in past the top and bottom edges
+    unsigned int stride = current_grid.alive.get_stride();
+    const std::uint64_t *alive = current_grid.alive.row_data(row);
+    const std::uint64_t *above = alive - stride;
+    const std::uint64_t *below = alive + stride;
+    std::uint64_t on_board = current_grid.alive.board_mask(word);
 
-// recalculate all game statistics
+    // the fate of every cell but those born by chance
+    BitGrid::NeighborCount count =
+            BitGrid::count_neighbors(above, alive, below, word);
+    std::uint64_t next = BitGrid::next_state(count, alive[word], rule);
+    std::uint64_t candidates = 0;
+    if (!rule.is_deterministic()) {
+        candidates = BitGrid::chance_births(count, alive[word], rule);
+    } // if
+    // survivors keep their alleles
+    std::uint64_t dominant[2];
+    for (int allele = 0; allele < 2; ++allele) {
+        dominant[allele] =
+                current_grid.dominant[allele].row_data(row)[word] & next;
+    } // for
+
+    // each newborn takes an allele from each of its first two neighbors in
+    // scan order, or both from a lone neighbor
+    std::uint64_t births = ((next & ~alive[word]) | candidates) & on_board;
+    if (births != 0) {
+        std::uint64_t neighbors[8];
+        std::uint64_t dominant_neighbors[2][8];
+        BitGrid::neighbor_words(above, alive, below, word, neighbors);
+        for (int allele = 0; allele < 2; ++allele) {
+            const std::uint64_t *middle =
+                    current_grid.dominant[allele].row_data(row);
+            BitGrid::neighbor_words(middle - stride, middle, middle + stride,
+                                    word, dominant_neighbors[allele]);
+        } // for
+        for (; births != 0; births &= births - 1) {
+            unsigned int bit =
+                    static_cast<unsigned int>(__builtin_ctzll(births));
+            std::uint64_t mask = std::uint64_t{1} << bit;
+            CounterRandom random =
+                    cell_random(row * width + word * BitGrid::WORD_BITS + bit);
+            // roll for a birth by chance
+            if ((candidates & mask) &&
+                random.uniform() > rule.birth_chance(count.at(bit))) {
+                continue;
+            } // if
+            int parents[2]{0, 0};
+            int found = 0;
+            for (int neighbor = 0; neighbor < 8 && found < 2; ++neighbor) {
+                if (neighbors[neighbor] & mask) {
+                    parents[found++] = neighbor;
+                } // if
+            }     // for
+            if (found == 1) {
+                parents[1] = parents[0];
+            } // if
+            // randomly choose an allele from each parent
+            next |= mask;
+            for (int allele = 0; allele < 2; ++allele) {
+                unsigned int inherited = random.bit();
+                if (dominant_neighbors[inherited][parents[allele]] & mask) {
+                    dominant[allele] |= mask;
+                } // if
+            }     // for
+        }         // for
+    }             // if
+
+    // keep the bits past the right edge of the board dead
+    next &= on_board;
+    next_grid.alive.row_data(row)[word] = next;
+    next_grid.dominant[0].row_data(row)[word] = dominant[0] & on_board;
+    next_grid.dominant[1].row_data(row)[word] = dominant[1] & on_board;
+
+    std::uint64_t changed = (next ^ alive[word]) & on_board;
+    // a cell that can be born by chance may be at any time
+    return changed | (candidates & on_board);
+} // step_word()
+
+// count the latest cells of word of row into counts
+void ModelAllele::count_word(unsigned int row, unsigned int word,
+                             AlleleCounts &counts) const {
+    std::uint64_t alive = next_grid.alive.row_data(row)[word];
+    std::uint64_t dominant_1 = next_grid.dominant[0].row_data(row)[word];
+    std::uint64_t dominant_2 = next_grid.dominant[1].row_data(row)[word];
+    counts.alive += static_cast<unsigned int>(__builtin_popcountll(alive));
+    counts.dominant +=
+            static_cast<unsigned int>(__builtin_popcountll(dominant_1) +
+                                      __builtin_popcountll(dominant_2));
+    counts.dominant_pheno += static_cast<unsigned int>(
+            __builtin_popcountll(dominant_1 | dominant_2));
+} // count_word()
+
+// recount the statistics recorded for the whole board
 void ModelAllele::update_stats() {
-    num_alive = 0;
-    num_dominant = 0;
-    num_recessive = 0;
-    num_dominant_pheno = 0;
-    num_recessive_pheno = 0;
-    for (unsigned int i = 0; i < width * height; ++i) {
-        if (next_grid[i].color != ModelAllele::IS_DEAD) {
-            ++num_alive;
-            next_grid[i].update_color();
-            if (next_grid[i].color == ModelAllele::DOMINANT) {
-                ++num_dominant_pheno;
-                // if either is recessive, then we have one recessive and one
-                // dominant
-                if (next_grid[i].allele_pair[0] == ModelAllele::RECESSIVE ||
-                    next_grid[i].allele_pair[1] == ModelAllele::RECESSIVE) {
-                    ++num_recessive;
-                    ++num_dominant;
-                } else {
-                    num_dominant += 2; // 2 dominant alleles present
-                }
-            } else if (next_grid[i].color == ModelAllele::RECESSIVE) {
-                ++num_recessive_pheno;
-                num_recessive += 2; // 2 recessive alleles present
-            }
-        }
-    }
+    ScopedPhase phase(timers, PhaseTimers::STATS);
+    pool.run(tiles.get_tile_rows(), [this](unsigned int tile_row) {
+        for (unsigned int word = 0; word < tiles.get_tile_cols(); ++word) {
+            count_tile(tile_row, word);
+        } // for
+    });
+    merge_counts();
 } // update_stats()
 
-// return the genome of the cell at position (x, y)
-std::string ModelAllele::get_geno(unsigned int x, unsigned int y) {
-    if (y * width + x >= width * height) {
+// recount the latest cells of a tile
+void ModelAllele::count_tile(unsigned int tile_row, unsigned int word) {
+    AlleleCounts &counts = tile_counts[tile_row * tiles.get_tile_cols() + word];
+    counts = AlleleCounts();
+    for (unsigned int row = tiles.row_begin(tile_row);
+         row < tiles.row_end(tile_row); ++row) {
+        count_word(row, word, counts);
+    } // for
+} // count_tile()
+
+// add up the counts of every tile
+void ModelAllele::merge_counts() {
+    AlleleCounts total;
+    for (const AlleleCounts &counts : tile_counts) {
+        total.alive += counts.alive;
+        total.dominant += counts.dominant;
+        total.dominant_pheno += counts.dominant_pheno;
+    } // for
+    num_alive = total.alive;
+    num_dominant = total.dominant;
+    num_recessive = 2 * total.alive - total.dominant;
+    num_dominant_pheno = total.dominant_pheno;
+    num_recessive_pheno = total.alive - total.dominant_pheno;
+} // merge_counts()
+
+// copy the edges of the latest board into its ghost cells if the board wraps
+// around; otherwise they stay dead
+void ModelAllele::wrap_halos() {
+    if (toroidal) {
+        next_grid.alive.wrap_halo();
+        next_grid.dominant[0].wrap_halo();
+        next_grid.dominant[1].wrap_halo();
+    } // if
+} // wrap_halos()
+
+// the genotype of the cell at column x and row y of a board, "DEAD" if it's
+// dead and "ERROR" if it's off the board
+std::string ModelAllele::genotype(const BitGrid &alive,
+                                  const BitGrid &dominant_1,
+                                  const BitGrid &dominant_2, unsigned int x,
+                                  unsigned int y) {
+    if (x >= alive.get_width() || y >= alive.get_height()) {
         return std::string("ERROR");
     }
 
-    CellAllele &curr = next_grid[y * width + x];
-    if (curr.color == IS_DEAD) {
+    if (!alive.get(y, x)) {
         return std::string("DEAD");
     }
     std::string geno;
-    char first = curr.allele_pair[0] == DOMINANT ? 'A' : 'a';
-    char second = curr.allele_pair[1] == DOMINANT ? 'A' : 'a';
+    char first = dominant_1.get(y, x) ? 'A' : 'a';
+    char second = dominant_2.get(y, x) ? 'A' : 'a';
     geno.push_back(first);
     geno.push_back(second);
     return geno;
-} // get_geno
+} // genotype()
 
 } // namespace GameOfLife
@@ -6,51 +6,128 @@
 #ifndef ModelAllele_hpp
 #define ModelAllele_hpp
 
-#include "CellAllele.hpp"
+#include "ActiveTiles.hpp"
+#include "BitGrid.hpp"
 #include "Model.hpp"
-#include "ViewAllele.hpp"
+#include "Recorder.hpp"
+#include <cstdint>
 #include <stdio.h>
 #include <string>
 #include <vector>
 
 namespace GameOfLife {
 
-class CellAllele;
-
 class ModelAllele : public Model {
 public:
-    // construct a ModelAllele
+    // construct a ModelAllele drawing to canvas, or to nothing if canvas is
+    // null,
+    // and recording to files named after output_file_name
     ModelAllele(unsigned int width, unsigned int height, double prob_alive,
-                double dom_frequency, ViewAllele &view);
-    // update the statistics recorded
+                double dom_frequency, const ModelOptions &options,
+                Canvas *canvas, std::string output_file_name);
+
+    // Game of Life, plus a 10% chance of birth with two neighbors
+    static constexpr const char *DEFAULT_RULE = "B3/S23/P2=0.1";
+    // the names of the statistics recorded each generation
+    static constexpr const char *STATS_HEADER =
+            "Generation,Dominant Frequency,Recessive Frequency,Dominant "
+            "Pheno. Frequency,Recessive Pheno. Frequency";
+    // recount the statistics recorded for the whole board
     void update_stats();
     // update the board, swapping the current grid with the next grid
     void update() override;
     // reset the game board
     void reset() override;
-    std::string get_geno(unsigned int x, unsigned int y);
+    // the genotype of the cell at column x and row y of a board, "DEAD" if
+    // it's dead and "ERROR" if it's off the board
+    static std::string genotype(const BitGrid &alive,
+                                const BitGrid &dominant_1,
+                                const BitGrid &dominant_2, unsigned int x,
+                                unsigned int y);
+    // the living cells of the latest board, valid until the model is next
+    // stepped or reset
+    const BitGrid &get_alive() const {
+        return next_grid.alive;
+    }
+    // whether the first or second allele of each latest cell is dominant,
+    // valid until the model is next stepped or reset
+    const BitGrid &get_dominant(int allele) const {
+        return next_grid.dominant[allele];
+    }
 
-private:
     // calculate the frequency of dominant alleles
-    double calc_dominant_freq();
+    double calc_dominant_freq() const;
     // calculate the frequency of recessive alleles
-    double calc_recessive_freq();
+    double calc_recessive_freq() const;
     // calculate the frequency of phenotypically dominant cells
-    double calc_dominant_pheno();
+    double calc_dominant_pheno() const;
     // calculate the frequency of phenotypically recessive cells
-    double calc_recessive_pheno();
+    double calc_recessive_pheno() const;
+    // start recording the statistics of each generation to a new file, or
+    // stop
+    void toggle_recording();
+    // the statistics of the latest board as a row of values under
+    // STATS_HEADER
+    std::string format_stats() const;
+    bool get_is_recording() const {
+        return recorder.get_is_recording();
+    }
+
+private:
     double dom_frequency; // initial frequency of dominant alleles
 
-    ViewAllele &view;
+    Recorder recorder;
+
+    // the numbers of living cells, dominant alleles and phenotypically
+    // dominant cells of one tile; the rest are recessive
+    struct AlleleCounts {
+        AlleleCounts() : alive(0), dominant(0), dominant_pheno(0) {}
+
+        unsigned int alive;
+        unsigned int dominant;
+        unsigned int dominant_pheno;
+    };
+
+    // a board stored as bitplanes, one bit per cell in each: whether the
+    // cell is alive, and whether each of its alleles is dominant; the
+    // alleles of dead cells are clear
+    struct Planes {
+        Planes(unsigned int width, unsigned int height)
+                : alive(width, height), dominant{BitGrid(width, height),
+                                                 BitGrid(width, height)} {}
+
+        BitGrid alive;
+        BitGrid dominant[2];
+    };
 
     // populate the grid with cells randomly
     void fill_grid();
-    void update_cell(unsigned int position, const CellAllele &cell);
+    // step the cells of a tile, one word wide, into the next grid, counting
+    // them, and return whether any changed or had a chance to
+    bool step_tile(unsigned int tile_row, unsigned int word);
+    // step word of row into the next grid, returning the cells that changed
+    // or had a chance to
+    std::uint64_t step_word(unsigned int row, unsigned int word);
+    // count the latest cells of word of row into counts
+    void count_word(unsigned int row, unsigned int word,
+                    AlleleCounts &counts) const;
+    // recount the latest cells of a tile
+    void count_tile(unsigned int tile_row, unsigned int word);
+    // add up the counts of every tile
+    void merge_counts();
+    // copy the edges of the latest board into its ghost cells if the board
+    // wraps around
+    void wrap_halos();
 
     // grid holding current board state
-    std::vector<CellAllele> current_grid;
+    Planes current_grid;
     // grid to write to for out of place calculation
-    std::vector<CellAllele> next_grid;
+    Planes next_grid;
+    // only tiles near last generation's changes get stepped; a tile is one
+    // word wide
+    ActiveTiles tiles;
+    // counts of each tile's latest cells; tiles left out keep theirs
+    std::vector<AlleleCounts> tile_counts;
 
     // number of recessive alleles (not cells!)
     unsigned int num_recessive;
@@ -60,12 +137,6 @@ private:
     unsigned int num_recessive_pheno;
     // frequency of phenotypically dominant cells
     unsigned int num_dominant_pheno;
-
-    // dom/recessive colors
-    static constexpr unsigned int DOMINANT = 0x0000FF;
-    static constexpr unsigned int RECESSIVE = 0xFFFF00;
-
-    friend class CellAllele;
 };
 
 } // namespace GameOfLife
@@ -3,17 +3,23 @@
  * A model class to handle the Average game mode.
  */
 #include "ModelAverage.hpp"
-#include "CellAverage.hpp"
+#include <algorithm>
+#include <cmath>
 
 namespace GameOfLife {
 
 ModelAverage::ModelAverage(unsigned int width, unsigned int height,
                            double prob_alive, bool sexual, double min_mutation,
                            double max_mutation, unsigned int ideal_color,
-                           ViewAverage &view)
-        : Model(width, height, prob_alive), view(view), sexual(sexual),
+                           const ModelOptions &options, Canvas *canvas,
+                           std::string output_file_name)
+        : Model(width, height, prob_alive, options, DEFAULT_RULE, canvas),
+          recorder(output_file_name, STATS_HEADER),
+          tiles(width, height, TILE_SIZE, options.toroidal),
+          distances_are_stale(false), sexual(sexual),
           min_mutation(min_mutation), max_mutation(max_mutation),
-          total_fitness(0), total_mutation_rate(0) {
+          fitness_stats(), total_mutation_rate(0),
+          mutation_sampler(MutationSampler::get()) {
     set_ideal_color(ideal_color);
     // store the original ideal color channels
     orig_ideal_red = ideal_red;
@@ -24,25 +30,35 @@ ModelAverage::ModelAverage(unsigned int width, unsigned int height,
 
 // reset the game board
 void ModelAverage::reset() {
+    seed_board();
     generations = 0;
     num_alive = 0;
-    total_fitness = 0;
+    fitness_stats = RunningStats();
     total_mutation_rate = 0;
     ideal_red = orig_ideal_red;
     ideal_green = orig_ideal_green;
     ideal_blue = orig_ideal_blue;
-    current_grid.clear();
-    current_grid.reserve(static_cast<std::size_t>(width * height));
-    next_grid.clear();
-    next_grid.reserve(static_cast<std::size_t>(width * height));
+    build_distance_tables();
+    std::size_t size = padded_size();
+    current_colors.assign(size, IS_DEAD);
+    next_colors.assign(size, IS_DEAD);
+    current_mutation_rates.assign(size, 0);
+    next_mutation_rates.assign(size, 0);
+    current_distances.assign(size, 0);
+    next_distances.assign(size, 0);
+    tile_stats.assign(tiles.get_tile_count(), TileStats());
+    color_counts.clear();
+    color_changes.assign(tiles.get_tile_rows(), ColorChanges());
+    distances_are_stale = false;
+    std::uniform_real_distribution<double> mut(min_mutation, max_mutation);
     for (unsigned int row = 0; row < height; ++row) {
         for (unsigned int col = 0; col < width; ++col) {
-            std::uniform_real_distribution<double> mut(min_mutation,
-                                                       max_mutation);
-            current_grid.emplace_back(row, col, 0, sexual, mut(rng), this);
-            next_grid.emplace_back(row, col, 0, sexual, mut(rng), this);
-        }
-    }
+            unsigned int pos = padded_index(row, col);
+            current_mutation_rates[pos] = static_cast<float>(mut(rng));
+            next_mutation_rates[pos] = static_cast<float>(mut(rng));
+        } // for
+    }     // for
+    tiles.activate_all();
     fill_grid();
 } // reset()
 
@@ -52,59 +68,286 @@ void ModelAverage::fill_grid() {
     std::uniform_int_distribution<int> color_gen(0, 5);
     // chance of a cell forming
     std::uniform_real_distribution<double> cells_chance(0.0, 1.0);
-    for (size_t pos = 0; pos < width * height; ++pos) {
-        double prob = cells_chance(rng);
-        unsigned int ideal_color = ((ideal_red & 0xFF) << 16) +
-                                   ((ideal_green & 0xFF) << 8) +
-                                   (ideal_blue & 0xFF);
-        if (prob <= prob_alive) {
-            next_grid[pos].color =
-                    static_cast<unsigned int>(start_colors[color_gen(rng)]);
-            double fitness = next_grid[pos].calc_fitness();
-            next_grid[pos].fitness = fitness;
-            total_mutation_rate += next_grid[pos].mutation_rate;
-            view.update(static_cast<unsigned int>(pos),
-                        static_cast<int>(next_grid[pos].color), 0u,
-                        ideal_color);
-        } else {
-            next_grid[pos].color = IS_DEAD;
-            view.update(static_cast<unsigned int>(pos), IS_DEAD, 0u,
-                        ideal_color);
-        } // else
+    for (unsigned int row = 0; row < height; ++row) {
+        for (unsigned int col = 0; col < width; ++col) {
+            unsigned int pos = padded_index(row, col);
+            double prob = cells_chance(rng);
+            if (prob <= prob_alive) {
+                next_colors[pos] = static_cast<unsigned int>(
+                        start_colors[color_gen(rng)]);
+            } else {
+                next_colors[pos] = IS_DEAD;
+            } // else
+            if (next_colors[pos] != IS_DEAD) {
+                ++color_counts[next_colors[pos]];
+            } // if
+        } // for
     }     // for
-    update_stats();
+    if (canvas != nullptr) {
+        canvas->set_generations(0u);
+    } // if
+    refresh_distances();
 } // fill_grid()
 
+// step the cells of a tile into the next grid, recording their statistics,
+// and return whether any changed or had a chance to
+template <bool Sexual>
+bool ModelAverage::step_tile(unsigned int tile_row, unsigned int tile_col) {
+    TileStats &stats = tile_stats[tile_row * tiles.get_tile_cols() + tile_col];
+    stats = TileStats();
+    bool changed = false;
+    for (unsigned int row = tiles.row_begin(tile_row);
+         row < tiles.row_end(tile_row); ++row) {
+        for (unsigned int col = tiles.col_begin(tile_col);
+             col < tiles.col_end(tile_col); ++col) {
+            changed |= update_cell<Sexual>(row, col, stats,
+                                           color_changes[tile_row]);
+        } // for
+    }     // for
+    return changed;
+} // step_tile()
+
+// step the cell at (row, col) into the next grid, adding it to stats if alive
+// and any change of color to color_changes, and return whether it changed or
+// had a chance to
+template <bool Sexual>
+bool ModelAverage::update_cell(unsigned int row, unsigned int col,
+                               TileStats &stats, ColorChanges &color_changes) {
+    unsigned int position = padded_index(row, col);
+    unsigned int color = current_colors[position];
+    unsigned int parents[2];
+    int neighbors = find_parents(row, col, parents);
+
+    unsigned int new_color = color;
+    float new_mutation_rate = current_mutation_rates[position];
+    bool born = false;
+    // only drawn from by cells that might be born
+    CounterRandom random = cell_random(row * width + col);
+    // look up what happens to the cell, rolling for births by chance
+    Rule::Outcome outcome = rule.outcome(color != IS_DEAD, neighbors);
+    if (color != IS_DEAD) {
+        new_color = outcome == Rule::LIVES ? color : IS_DEAD;
+    } else {
+        born = outcome == Rule::LIVES ||
+               (outcome == Rule::CHANCE &&
+                random.uniform() <= rule.birth_chance(neighbors));
+    } // if/else
+
+    if (born) {
+        unsigned int color_1 = current_colors[parents[0]];
+        new_mutation_rate = current_mutation_rates[parents[0]];
+        // if asexual, just copy the parent, otherwise average the parents
+        if constexpr (Sexual) {
+            unsigned int color_2 = current_colors[parents[1]];
+            unsigned int red =
+                    (((color_1 >> 16) & 0xFF) + ((color_2 >> 16) & 0xFF)) / 2;
+            unsigned int green =
+                    (((color_1 >> 8) & 0xFF) + ((color_2 >> 8) & 0xFF)) / 2;
+            unsigned int blue = ((color_1 & 0xFF) + (color_2 & 0xFF)) / 2;
+            color_1 = ((red & 0xff) << 16) + ((green & 0xff) << 8) +
+                      (blue & 0xff);
+            new_mutation_rate = new_mutation_rate / 2 +
+                                current_mutation_rates[parents[1]] / 2;
+        } // if
+        new_color = mutate_color(color_1, new_mutation_rate, random);
+    } // if
+
+    // a survivor keeps its distance, which refresh_distances() recomputes
+    // whenever the ideal color changes
+    std::uint32_t new_distance = 0;
+    if (born) {
+        new_distance = squared_distance(new_color);
+    } else if (new_color != IS_DEAD) {
+        new_distance = current_distances[position];
+    } // if
+    if (new_color != IS_DEAD) {
+        stats.fitness.add(calc_fitness(new_distance));
+        stats.mutation_rate += new_mutation_rate;
+    } // if
+
+    // only cells whose color changed are counted again
+    if (new_color != color) {
+        if (color != IS_DEAD) {
+            color_changes.emplace_back(color, -1);
+        } // if
+        if (new_color != IS_DEAD) {
+            color_changes.emplace_back(new_color, 1);
+        } // if
+    }     // if
+
+    next_colors[position] = new_color;
+    next_mutation_rates[position] = new_mutation_rate;
+    next_distances[position] = new_distance;
+    // a cell that can be born by chance may be at any time
+    return new_color != color || outcome == Rule::CHANCE;
+} // update_cell()
+
 // update the baord for the next generation
 void ModelAverage::update() {
-    current_grid.swap(next_grid);
+    // parents are picked by distance, so it has to be up to date
+    if (distances_are_stale) {
+        refresh_distances();
+    } // if
+    // a tile left out keeps the same cells in both grids, since nothing near
+    // it changed last generation
+    current_colors.swap(next_colors);
+    current_mutation_rates.swap(next_mutation_rates);
+    current_distances.swap(next_distances);
     ++generations;
-    for (unsigned int i = 0; i < width * height; ++i) {
-        current_grid[i].update();
-    } // for
-    update_stats();
-    // write data to file
-    if (is_recording) {
-        view.write_data(num_alive, calc_average_mutation_rate(),
-                        calc_average_fitness(), calc_fitness_deviation());
+    // statistics are gathered while stepping, so the board is only swept
+    // once per generation
+    if (sexual) {
+        tiles.step_active(pool, [this](unsigned int tile_row,
+                                       unsigned int tile_col) {
+            return step_tile<true>(tile_row, tile_col);
+        });
+    } else {
+        tiles.step_active(pool, [this](unsigned int tile_row,
+                                       unsigned int tile_col) {
+            return step_tile<false>(tile_row, tile_col);
+        });
+    } // if/else
+    {
+        ScopedPhase phase(timers, PhaseTimers::STATS);
+        merge_stats();
+        merge_color_changes();
     }
+    if (canvas != nullptr) {
+        canvas->set_generations(generations);
+    } // if
+    wrap_halos();
+    // write data to file
+    if (recorder.get_is_recording()) {
+        std::string row;
+        {
+            ScopedPhase phase(timers, PhaseTimers::STATS);
+            row = format_stats();
+        }
+        ScopedPhase phase(timers, PhaseTimers::RECORD);
+        recorder.write_row(row);
+    } // if
 } // update()
 
-// update the cell at position to be the same as input cell
-void ModelAverage::update_cell(unsigned int position, const CellAverage &cell) {
-    next_grid[position] = cell;
-    unsigned int ideal_color = ((ideal_red & 0xFF) << 16) +
-                               ((ideal_green & 0xFF) << 8) +
-                               (ideal_blue & 0xFF);
-    view.update(position, static_cast<int>(cell.color), generations,
-                ideal_color);
-} // update_cell
+// the statistics of the latest board as a row of values under STATS_HEADER
+std::string ModelAverage::format_stats() const {
+    std::string row = std::to_string(generations);
+    row += ',';
+    row += std::to_string(get_ideal_color());
+    row += ',';
+    row += std::to_string(num_alive);
+    row += ',';
+    row += std::to_string(calc_average_mutation_rate());
+    row += ',';
+    row += std::to_string(calc_average_fitness());
+    row += ',';
+    row += std::to_string(calc_fitness_deviation());
+    return row;
+} // format_stats()
+
+// start recording the statistics of each generation to a new file, or stop
+void ModelAverage::toggle_recording() {
+    recorder.toggle_recording();
+} // toggle_recording()
+
+// count the living neighbors of (row, col), storing the positions of the two
+// most fit
+int ModelAverage::find_parents(unsigned int row, unsigned int col,
+                               unsigned int parents[2]) const {
+    int num_neighbors = 0;
+    // the closer to the ideal color, the fitter
+    std::uint32_t best_distance = UINT32_MAX;
+    std::uint32_t second_best_distance = UINT32_MAX;
+    // the ghost cells around the board stand in for neighbors past its edges
+    unsigned int center = padded_index(row, col);
+    unsigned int stride = width + 2;
+    for (unsigned int row_start = center - stride - 1;
+         row_start <= center + stride - 1; row_start += stride) {
+        for (unsigned int position = row_start; position < row_start + 3;
+             ++position) {
+            if (position == center) {
+                continue;
+            } // if
+            if (current_colors[position] != IS_DEAD) {
+                ++num_neighbors;
+                std::uint32_t distance = current_distances[position];
+                if (distance <= best_distance) {
+                    second_best_distance = best_distance;
+                    parents[1] = parents[0];
+                    best_distance = distance;
+                    parents[0] = position;
+                } else if (distance <= second_best_distance) {
+                    second_best_distance = distance;
+                    parents[1] = position;
+                } // if
+            }     // if
+        }         // for
+    }             // for
+    // a lone parent reproduces with itself
+    if (num_neighbors == 1) {
+        parents[1] = parents[0];
+    } // if
+    return num_neighbors;
+} // find_parents()
+
+// slightly change a color based on a mutation rate
+unsigned int ModelAverage::mutate_color(unsigned int color,
+                                        double mutation_rate,
+                                        CounterRandom &random) const {
+    if (mutation_rate == 0) return color;
+    unsigned int rgb[3]{((color >> 16) & 0xFF), ((color >> 8) & 0xFF),
+                        (color & 0xFF)};
+    for (int i = 0; i < 3; ++i) {
+        unsigned int channel = rgb[i];
+        // one word per channel: the top bit picks the direction and the rest
+        // whether it changes at all
+        std::uint32_t word = random.next();
+        std::uint32_t chance_bits = word & 0x7FFFFFFF;
+        // if the sign is 1, then increase the color channel if possible
+        if ((word >> 31) && channel < 0xFF) {
+            rgb[i] += mutation_sampler.raise(0xFF - channel, mutation_rate,
+                                             chance_bits, random);
+        } else if (channel > 0x0) {
+            // otherwise decrease the color channel if possible
+            rgb[i] -= mutation_sampler.lower(channel, mutation_rate,
+                                             chance_bits, random);
+        } // if
+    }     // for
+    return ((rgb[0] & 0xFF) << 16) + ((rgb[1] & 0xFF) << 8) + (rgb[2] & 0xFF);
+} // mutate_color()
+
+// the fitness of a color at a squared distance from the ideal color, as a
+// percentage of the largest distance possible
+double ModelAverage::calc_fitness(std::uint32_t squared_distance) {
+    double dist = std::sqrt(static_cast<double>(squared_distance));
+    return 100 * (MAX_DISTANCE - dist) / MAX_DISTANCE;
+} // calc_fitness()
+
+// rebuild the squared difference of each channel value from the ideal color
+void ModelAverage::build_distance_tables() {
+    unsigned int ideal[3]{ideal_red, ideal_green, ideal_blue};
+    for (int channel = 0; channel < 3; ++channel) {
+        for (unsigned int value = 0; value < 256; ++value) {
+            unsigned int difference = value > ideal[channel]
+                                              ? value - ideal[channel]
+                                              : ideal[channel] - value;
+            channel_distances[channel][value] = difference * difference;
+        } // for
+    }     // for
+} // build_distance_tables()
+
+// the ideal color packed as 0xRRGGBB
+unsigned int ModelAverage::get_ideal_color() const {
+    return ((ideal_red & 0xFF) << 16) + ((ideal_green & 0xFF) << 8) +
+           (ideal_blue & 0xFF);
+} // get_ideal_color()
 
 // set the ideal color for determining fitness
 void ModelAverage::set_ideal_color(unsigned int ideal_color) {
     ideal_red = (ideal_color >> 16) & 0xFF;
     ideal_green = (ideal_color >> 8) & 0xFF;
     ideal_blue = ideal_color & 0xFF;
+    build_distance_tables();
+    distances_are_stale = true;
 } // set_ideal_color()
 
 // increase each channel of the ideal color by the given amounts
@@ -123,11 +366,13 @@ void ModelAverage::increase_ideal_color(int d_red, int d_green, int d_blue) {
          0xFF - ideal_blue >= static_cast<unsigned int>(d_blue))) {
         ideal_blue += static_cast<unsigned int>(d_blue);
     }
+    build_distance_tables();
+    distances_are_stale = true;
 } // increase_ideal_color()
 
 // calculate the average fitness among all living cells
 double ModelAverage::calc_average_fitness() const {
-    return total_fitness / static_cast<double>(num_alive);
+    return fitness_stats.get_mean();
 }
 
 // calculate the average mutation rate among all living cells
@@ -137,33 +382,107 @@ double ModelAverage::calc_average_mutation_rate() const {
 
 // calculate the standard deviation of fitness among living cells
 double ModelAverage::calc_fitness_deviation() const {
-    double average = calc_average_fitness();
-    double sum = 0;
-    for (unsigned int i = 0; i < width * height; ++i) {
-        if (current_grid[i].color != ModelAverage::IS_DEAD) {
-            double temp = current_grid[i].fitness - average;
-            sum += temp * temp;
-        }
-    }
-    sum /= static_cast<double>(num_alive);
-    return std::pow(sum, 0.5);
+    return std::sqrt(fitness_stats.get_variance());
 }
 
-// recompute all statistics for the current board
+// recompute the fitness statistics after the ideal color changes, from the
+// distinct colors on the board rather than from every cell; the cells' own
+// distances are refreshed before the next generation
 void ModelAverage::update_stats() {
-    total_fitness = 0;
-    total_mutation_rate = 0;
-    num_alive = 0;
-    for (unsigned int i = 0; i < width * height; ++i) {
-        if (next_grid[i].color != ModelAverage::IS_DEAD) {
-            next_grid[i].fitness = next_grid[i].calc_fitness();
-            total_fitness += next_grid[i].fitness;
-            total_mutation_rate += next_grid[i].mutation_rate;
-            ++num_alive;
-        } else {
-            next_grid[i].fitness = 0;
-        } // if/else
-    }     // for
+    ScopedPhase phase(timers, PhaseTimers::STATS);
+    fitness_stats = RunningStats();
+    for (const auto &color_count : color_counts) {
+        fitness_stats.add(calc_fitness(squared_distance(color_count.first)),
+                          static_cast<std::uint64_t>(color_count.second));
+    } // for
+    distances_are_stale = true;
 } // update_stats()
 
+// add the changes to the color counts made while stepping, each color's net
+// change at once
+void ModelAverage::merge_color_changes() {
+    // the counts only change by cells that were born, died or changed
+    // color; sorting each row's changes by color lines up those of a color
+    for (ColorChanges &changes : color_changes) {
+        std::sort(changes.begin(), changes.end());
+        for (std::size_t first = 0; first < changes.size();) {
+            std::uint32_t color = changes[first].first;
+            int change = 0;
+            std::size_t next = first;
+            for (; next < changes.size() && changes[next].first == color;
+                 ++next) {
+                change += changes[next].second;
+            } // for
+            if (change != 0) {
+                int &count = color_counts[color];
+                count += change;
+                if (count == 0) {
+                    color_counts.erase(color);
+                } // if
+            } // if
+            first = next;
+        } // for
+        changes.clear();
+    } // for
+} // merge_color_changes()
+
+// recompute the distance of every cell from the ideal color and all
+// statistics for the latest board
+void ModelAverage::refresh_distances() {
+    pool.run(tiles.get_tile_rows(), [this](unsigned int tile_row) {
+        for (unsigned int tile_col = 0; tile_col < tiles.get_tile_cols();
+             ++tile_col) {
+            measure_tile(tile_row, tile_col);
+        } // for
+    });
+    merge_stats();
+    wrap_halos();
+    distances_are_stale = false;
+} // refresh_distances()
+
+// recompute the distances and statistics of the latest cells of a tile; the
+// distances go in both grids, since a tile left out next generation keeps
+// the same cells in both
+void ModelAverage::measure_tile(unsigned int tile_row, unsigned int tile_col) {
+    TileStats &stats = tile_stats[tile_row * tiles.get_tile_cols() + tile_col];
+    stats = TileStats();
+    for (unsigned int row = tiles.row_begin(tile_row);
+         row < tiles.row_end(tile_row); ++row) {
+        for (unsigned int col = tiles.col_begin(tile_col);
+             col < tiles.col_end(tile_col); ++col) {
+            unsigned int position = padded_index(row, col);
+            std::uint32_t distance = 0;
+            if (next_colors[position] != IS_DEAD) {
+                distance = squared_distance(next_colors[position]);
+                stats.fitness.add(calc_fitness(distance));
+                stats.mutation_rate += next_mutation_rates[position];
+            } // if
+            current_distances[position] = distance;
+            next_distances[position] = distance;
+        } // for
+    }     // for
+} // measure_tile()
+
+// combine the statistics of every tile, always in the same order so the
+// result doesn't depend on which threads stepped which tiles
+void ModelAverage::merge_stats() {
+    fitness_stats = RunningStats();
+    total_mutation_rate = 0;
+    for (const TileStats &stats : tile_stats) {
+        fitness_stats.merge(stats.fitness);
+        total_mutation_rate += stats.mutation_rate;
+    } // for
+    num_alive = static_cast<unsigned int>(fitness_stats.get_count());
+} // merge_stats()
+
+// copy the edges of the latest board into its ghost cells if the board wraps
+// around; otherwise they stay dead
+void ModelAverage::wrap_halos() {
+    if (toroidal) {
+        wrap_halo(next_colors);
+        wrap_halo(next_mutation_rates);
+        wrap_halo(next_distances);
+    } // if
+} // wrap_halos()
+
 } // namespace GameOfLife
@@ -6,21 +6,36 @@
 #ifndef ModelAverage_hpp
 #define ModelAverage_hpp
 
-#include "CellAverage.hpp"
+#include "ActiveTiles.hpp"
+#include "GridView.hpp"
 #include "Model.hpp"
-#include "ViewAverage.hpp"
+#include "MutationSampler.hpp"
+#include "Recorder.hpp"
+#include "RunningStats.hpp"
+#include <cstdint>
 #include <stdio.h>
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace GameOfLife {
 
-class CellAverage;
-
 class ModelAverage : public Model {
 public:
+    // construct a ModelAverage drawing to canvas, or to nothing if canvas
+    // is null, and recording to files named after output_file_name
     ModelAverage(unsigned int width, unsigned int height, double prob_alive,
                  bool sexual, double min_mutation, double max_mutation,
-                 unsigned int ideal_color, ViewAverage &view);
+                 unsigned int ideal_color, const ModelOptions &options,
+                 Canvas *canvas, std::string output_file_name);
+
+    // Game of Life, plus a 10% chance of birth with two neighbors
+    static constexpr const char *DEFAULT_RULE = "B3/S23/P2=0.1";
+    // the names of the statistics recorded each generation
+    static constexpr const char *STATS_HEADER =
+            "Generation,Ideal Color,Living,Mutation Rate,Fitness,Fitness "
+            "Deviation";
 
     // update the baord for the next generation
     void update() override;
@@ -30,6 +45,20 @@ public:
     void set_ideal_color(unsigned int ideal_color_);
     // increase each channel of the ideal color by the given amounts
     void increase_ideal_color(int d_red, int d_green, int d_blue);
+    // the ideal color packed as 0xRRGGBB
+    unsigned int get_ideal_color() const;
+    // the colors of the latest cells, IS_DEAD if dead, valid until the model
+    // is next stepped or reset
+    GridView<std::uint32_t> get_colors() const {
+        return GridView<std::uint32_t>(&next_colors[padded_index(0, 0)],
+                                       width, height, width + 2);
+    }
+    // the mutation rates of the latest cells, valid until the model is next
+    // stepped or reset
+    GridView<float> get_mutation_rates() const {
+        return GridView<float>(&next_mutation_rates[padded_index(0, 0)],
+                               width, height, width + 2);
+    }
 
     // calculate the average fitness among all living cells
     double calc_average_fitness() const;
@@ -37,18 +66,103 @@ public:
     double calc_average_mutation_rate() const;
     // calculate the standard deviation of fitness among living cells
     double calc_fitness_deviation() const;
-    // recompute all statistics for the current board
+    // recompute the fitness statistics after the ideal color changes, from
+    // the distinct colors on the board rather than from every cell; the
+    // cells' own fitness is refreshed before the next generation
     void update_stats();
+    // start recording the statistics of each generation to a new file, or
+    // stop
+    void toggle_recording();
+    // the statistics of the latest board as a row of values under
+    // STATS_HEADER
+    std::string format_stats() const;
+    bool get_is_recording() const {
+        return recorder.get_is_recording();
+    }
 
 private:
-    ViewAverage &view;
+    Recorder recorder;
     // fill the grid with random cells based on input probabilities
     void fill_grid();
-    // update the cell at position to be the same as input cell
-    void update_cell(unsigned int position, const CellAverage &cell);
+    // copy the edges of the latest board into its ghost cells if the board
+    // wraps around; otherwise they stay dead
+    void wrap_halos();
+    // the statistics of the living cells of one tile
+    struct TileStats {
+        TileStats() : fitness(), mutation_rate(0) {}
+
+        RunningStats fitness;
+        double mutation_rate; // total
+    };
+
+    // the number of living cells of each color
+    typedef std::unordered_map<std::uint32_t, int> ColorCounts;
+    // changes to the number of living cells of a color, one cell at a time
+    typedef std::vector<std::pair<std::uint32_t, int>> ColorChanges;
 
-    std::vector<CellAverage> current_grid;
-    std::vector<CellAverage> next_grid;
+    // step the cells of a tile into the next grid, recording their
+    // statistics, and return whether any changed or had a chance to
+    template <bool Sexual>
+    bool step_tile(unsigned int tile_row, unsigned int tile_col);
+    // step the cell at (row, col) into the next grid, adding it to stats if
+    // alive and any change of color to color_changes, and return whether it
+    // changed or had a chance to; specialized on the mode of reproduction
+    template <bool Sexual>
+    bool update_cell(unsigned int row, unsigned int col, TileStats &stats,
+                     ColorChanges &color_changes);
+    // recompute the distance of every cell from the ideal color and all
+    // statistics for the latest board
+    void refresh_distances();
+    // recompute the distances and statistics of the latest cells of a tile
+    void measure_tile(unsigned int tile_row, unsigned int tile_col);
+    // combine the statistics of every tile, always in the same order
+    void merge_stats();
+    // add the changes to the color counts made while stepping, each color's
+    // net change at once
+    void merge_color_changes();
+    // count the living neighbors of (row, col), storing the positions of the
+    // two most fit
+    int find_parents(unsigned int row, unsigned int col,
+                     unsigned int parents[2]) const;
+    // slightly change a color based on a mutation rate
+    unsigned int mutate_color(unsigned int color, double mutation_rate,
+                              CounterRandom &random) const;
+    // the squared Euclidean distance between color and the ideal color
+    std::uint32_t squared_distance(std::uint32_t color) const {
+        return channel_distances[0][(color >> 16) & 0xFF] +
+               channel_distances[1][(color >> 8) & 0xFF] +
+               channel_distances[2][color & 0xFF];
+    }
+    // the fitness of a color at a squared distance from the ideal color, as
+    // a percentage of the largest distance possible
+    static double calc_fitness(std::uint32_t squared_distance);
+    // rebuild the squared difference of each channel value from the ideal
+    // color
+    void build_distance_tables();
+
+    // the board, one array per property, indexed by padded_index(); a color
+    // of IS_DEAD marks a dead cell
+    std::vector<std::uint32_t> current_colors;
+    std::vector<std::uint32_t> next_colors;
+    std::vector<float> current_mutation_rates;
+    std::vector<float> next_mutation_rates;
+    // squared distance of each living cell's color from the ideal color
+    std::vector<std::uint32_t> current_distances;
+    std::vector<std::uint32_t> next_distances;
+
+    // only tiles near last generation's changes get stepped
+    ActiveTiles tiles;
+    static constexpr unsigned int TILE_SIZE = 32;
+    // statistics of each tile's latest cells; tiles left out keep theirs
+    std::vector<TileStats> tile_stats;
+    // how many living cells have each color
+    ColorCounts color_counts;
+    // changes to color_counts made by each row of tiles while stepping,
+    // added once the generation is done
+    std::vector<ColorChanges> color_changes;
+    // whether the ideal color changed since the cells' distances were
+    // computed
+    bool distances_are_stale;
 
     // ROYGBV
     int start_colors[6]{0xFF0000, 0xFF7F00, 0xFFFF00,
@@ -63,14 +177,23 @@ private:
     unsigned int ideal_red, orig_ideal_red;
     unsigned int ideal_green, orig_ideal_green;
     unsigned int ideal_blue, orig_ideal_blue;
+    // squared difference of each red, green and blue value from the ideal
+    // color's, so fitness is ranked without a square root
+    std::uint32_t channel_distances[3][256];
 
     bool sexual;
     double min_mutation;
     double max_mutation;
 
-    double total_fitness;
+    RunningStats fitness_stats;
     double total_mutation_rate;
-    friend class CellAverage;
+
+    // draws the size of each mutation
+    const MutationSampler &mutation_sampler;
+
+    // max distance between any two colors (white and black)
+    static constexpr double MAX_DISTANCE =
+            441.67295593006370984949881708399745357;
 };
 
 } // namespace GameOfLife
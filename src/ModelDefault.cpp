@@ -4,31 +4,28 @@
  */
 
 #include "ModelDefault.hpp"
-#include "CellDefault.hpp"
+#include <utility>
 
 namespace GameOfLife {
 
 ModelDefault::ModelDefault(unsigned int width, unsigned int height,
-                           double prob_alive, ViewDefault &view)
-        : Model(width, height, prob_alive), view(view) {
+                           double prob_alive, const ModelOptions &options,
+                           Canvas *canvas)
+        : Model(width, height, prob_alive, options, DEFAULT_RULE, canvas),
+          current_grid(width, height), next_grid(width, height),
+          tiles(width, height, BitGrid::WORD_BITS, options.toroidal),
+          hashlife(rule), step_exponent(0),
+          fast_forward_error(nullptr) {
     reset();
 } // ModelDefault()
 
 // reset the board
 void ModelDefault::reset() {
+    seed_board();
     generations = 0;
     current_grid.clear();
-    current_grid.reserve(static_cast<std::size_t>(width * height));
     next_grid.clear();
-    next_grid.reserve(static_cast<std::size_t>(width * height));
-    for (unsigned int row = 0; row < height; ++row) {
-        for (unsigned int col = 0; col < width; ++col) {
-            current_grid.emplace_back(row, col,
-                                      static_cast<unsigned int>(IS_DEAD), this);
-            next_grid.emplace_back(row, col, static_cast<unsigned int>(IS_DEAD),
-                                   this);
-        }
-    }
+    tiles.activate_all();
     fill_grid();
 } // reset()
 
@@ -36,33 +33,84 @@ void ModelDefault::reset() {
 void ModelDefault::fill_grid() {
     // chance of a cell forming
     std::uniform_real_distribution<double> cells_chance(0.0, 1.0);
-    for (size_t pos = 0; pos < width * height; ++pos) {
-        double prob = cells_chance(rng);
-        if (prob <= prob_alive) {
-            next_grid[pos].color = IS_ALIVE;
-            view.update(static_cast<unsigned int>(pos), IS_ALIVE, 0u);
-        } else {
-            next_grid[pos].color = IS_DEAD;
-            view.update(static_cast<unsigned int>(pos), IS_DEAD, 0u);
-        } // else
-    }     // for
-} // fill_grid()
-
-// update the game board to the next generation
-void ModelDefault::update() {
-    current_grid.swap(next_grid);
-    ++generations;
     for (unsigned int row = 0; row < height; ++row) {
         for (unsigned int col = 0; col < width; ++col) {
-            current_grid[row * width + col].update();
+            double prob = cells_chance(rng);
+            next_grid.set(row, col, prob <= prob_alive);
         } // for
     }     // for
+    num_alive = next_grid.count_alive();
+    if (canvas != nullptr) {
+        canvas->set_generations(0u);
+    } // if
+} // fill_grid()
+
+// update the game board to the next generation, or skip ahead 2^k
+// generations at once with HashLife
+void ModelDefault::update() {
+    std::uint64_t advanced = 0;
+    if (step_exponent > 0) {
+        advanced = hashlife.advance(next_grid, step_exponent);
+        generations += advanced;
+        tiles.activate_all();
+        if (advanced < std::uint64_t{1} << step_exponent) {
+            // HashLife can't fit even a generation of the board in its
+            // cache, so it's stepped a generation at a time from now on
+            step_exponent = 0;
+            fast_forward_error = "board too large";
+        } // if
+    } // if
+    if (advanced == 0) {
+        // a tile left out keeps the same cells in both boards, since nothing
+        // near it changed last generation
+        std::swap(current_grid, next_grid);
+        ++generations;
+        if (toroidal) {
+            current_grid.wrap_halo();
+        } // if
+        // rows of tiles only read the current board and write their own
+        // rows of the next one, so they're stepped in parallel
+        tiles.step_active(pool, [this](unsigned int row, unsigned int col) {
+            return BitGrid::step(current_grid, next_grid, rule,
+                                 tiles.row_begin(row), tiles.row_end(row),
+                                 col, col + 1, get_board_key(), generations);
+        });
+    } // if
+    if (canvas != nullptr) {
+        canvas->set_generations(generations);
+    } // if
+    num_alive = next_grid.count_alive();
 } // update()
 
-// update the cell at position with the contents of the input cell
-void ModelDefault::update_cell(unsigned int position, const CellDefault &cell) {
-    next_grid[position] = cell;
-    view.update(position, static_cast<int>(cell.color), generations);
-} // update_cell
+// the statistics of the latest board as a row of values under STATS_HEADER
+std::string ModelDefault::format_stats() const {
+    return std::to_string(generations) + ',' + std::to_string(num_alive);
+} // format_stats()
+
+// change the number of generations per update (2^step_exponent), unless
+// HashLife can't step this board
+void ModelDefault::increase_step_exponent(int delta) {
+    // HashLife only follows rules without chance on a board bordered by dead
+    // cells, and treats dead blocks as staying dead
+    if (!rule.is_deterministic()) {
+        fast_forward_error = "rule has chance";
+        return;
+    } // if
+    if (rule.births_without_neighbors()) {
+        fast_forward_error = "rule has B0";
+        return;
+    } // if
+    if (toroidal) {
+        fast_forward_error = "board wraps around";
+        return;
+    } // if
+    fast_forward_error = nullptr;
+    if (delta < 0 && step_exponent >= static_cast<unsigned int>(-delta)) {
+        step_exponent -= static_cast<unsigned int>(-delta);
+    } else if (delta > 0 && MAX_STEP_EXPONENT - step_exponent >=
+                                    static_cast<unsigned int>(delta)) {
+        step_exponent += static_cast<unsigned int>(delta);
+    } // if
+} // increase_step_exponent()
 
 } // namespace GameOfLife
@@ -6,35 +6,65 @@
 #ifndef ModelDefault_hpp
 #define ModelDefault_hpp
 
-#include "CellDefault.hpp"
+#include "ActiveTiles.hpp"
+#include "BitGrid.hpp"
+#include "HashLife.hpp"
 #include "Model.hpp"
-#include "ViewDefault.hpp"
 #include <stdio.h>
+#include <string>
 
 namespace GameOfLife {
 
-class CellDefault;
-
 class ModelDefault : public Model {
 public:
+    // construct a ModelDefault drawing to canvas, or to nothing if canvas
+    // is null
     ModelDefault(unsigned int width, unsigned int height, double prob_alive,
-                 ViewDefault &view);
+                 const ModelOptions &options, Canvas *canvas);
     // update the game board to the next generation
     void update() override;
     // reset the boards
     void reset() override;
+    // change the number of generations per update (2^step_exponent), unless
+    // HashLife can't step this board
+    void increase_step_exponent(int delta);
+    unsigned int get_step_exponent() const {
+        return step_exponent;
+    }
+    // why the board isn't being fast-forwarded, if the last change to the
+    // step was refused or HashLife gave up on the board since, or null
+    const char *get_fast_forward_error() const {
+        return fast_forward_error;
+    }
+    // the latest board, valid until the model is next stepped or reset
+    const BitGrid &get_grid() const {
+        return next_grid;
+    }
+    // the statistics of the latest board as a row of values under
+    // STATS_HEADER
+    std::string format_stats() const;
+
+    static constexpr unsigned int MAX_STEP_EXPONENT = 30;
+    // Conway's Game of Life
+    static constexpr const char *DEFAULT_RULE = "B3/S23";
+    // the names of the statistics of each generation
+    static constexpr const char *STATS_HEADER = "Generation,Living";
 
 private:
-    ViewDefault &view;
     // fill the grid with random cells
     void fill_grid();
-    // update the cell at position with the contents of the input cell
-    void update_cell(unsigned int position, const CellDefault &cell);
 
-    std::vector<CellDefault> current_grid;
-    std::vector<CellDefault> next_grid;
+    // boards packed 64 cells to a word, stepped out of place
+    BitGrid current_grid;
+    BitGrid next_grid;
+    // tiles one word wide, so only regions that are still changing get
+    // stepped
+    ActiveTiles tiles;
 
-    friend class CellDefault;
+    // fast-forwards the board when stepping more than one generation
+    HashLife hashlife;
+    unsigned int step_exponent;
+    const char *fast_forward_error;
 };
 
 } // namespace GameOfLife
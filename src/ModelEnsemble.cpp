@@ -0,0 +1,390 @@
+/*
+ * ModelEnsemble.cpp
+ * Up to 64 replicates of the Default or Allele mode stepped together. Bit r
+ * of every cell's word belongs to replicate r, so one pass of the adders
+ * over a cell's neighbors steps the cell in every replicate at once, and
+ * bit r of every random word drawn for the cell is replicate r's own.
+ */
+
+#include "ModelEnsemble.hpp"
+#include "ModelAllele.hpp"
+#include "ModelDefault.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace GameOfLife {
+
+// construct an ensemble of replicates of the Default or Allele mode
+ModelEnsemble::ModelEnsemble(unsigned int width, unsigned int height,
+                             double prob_alive, bool allele,
+                             double dom_frequency, unsigned int replicates,
+                             const ModelOptions &options)
+        : Model(width, height, prob_alive, options,
+                allele ? ModelAllele::DEFAULT_RULE
+                       : ModelDefault::DEFAULT_RULE,
+                nullptr),
+          is_allele(allele), dom_frequency(dom_frequency),
+          replicates(replicates), replicate_mask(~std::uint64_t{0}),
+          chance_thresholds(),
+          block_counts((height + BLOCK_ROWS - 1) / BLOCK_ROWS),
+          replicate_counts() {
+    if (replicates == 0 || replicates > MAX_REPLICATES) {
+        throw std::invalid_argument(
+                "an ensemble needs 1 to " + std::to_string(MAX_REPLICATES) +
+                " replicates, not " + std::to_string(replicates));
+    } // if
+    if (replicates < MAX_REPLICATES) {
+        replicate_mask = (std::uint64_t{1} << replicates) - 1;
+    } // if
+    for (int neighbors = 0; neighbors <= Rule::MAX_NEIGHBORS; ++neighbors) {
+        chance_thresholds[neighbors] = static_cast<std::uint64_t>(
+                rule.birth_chance(neighbors) * 4294967296.0);
+    } // for
+    reset();
+} // ModelEnsemble()
+
+// refill every replicate with new cells
+void ModelEnsemble::reset() {
+    seed_board();
+    generations = 0;
+    std::size_t size = padded_size();
+    current_alive.assign(size, 0);
+    next_alive.assign(size, 0);
+    // Default replicates have no alleles
+    for (int which = 0; which < 2; ++which) {
+        current_dominant[which].assign(is_allele ? size : 0, 0);
+        next_dominant[which].assign(is_allele ? size : 0, 0);
+    } // for
+    fill_grid();
+} // reset()
+
+// fill every replicate with random cells, drawing the same numbers in the
+// same order as a model seeded replicate higher
+void ModelEnsemble::fill_grid() {
+    std::uniform_real_distribution<double> cells_chance(0.0, 1.0);
+    std::minstd_rand fill_rng;
+    for (unsigned int replicate = 0; replicate < replicates; ++replicate) {
+        seed_fill(fill_rng, make_board_key(replicate));
+        std::uint64_t lane = std::uint64_t{1} << replicate;
+        for (unsigned int row = 0; row < height; ++row) {
+            for (unsigned int col = 0; col < width; ++col) {
+                unsigned int pos = padded_index(row, col);
+                if (cells_chance(fill_rng) > prob_alive) {
+                    continue;
+                } // if
+                next_alive[pos] |= lane;
+                if (!is_allele) {
+                    continue;
+                } // if
+                // randomly set the allele pair
+                for (int which = 0; which < 2; ++which) {
+                    if (cells_chance(fill_rng) <= dom_frequency) {
+                        next_dominant[which][pos] |= lane;
+                    } // if
+                }     // for
+            }         // for
+        }             // for
+    }                 // for
+
+    // count the first generation like any other
+    LaneCounter alive_counter, dominant_counter, pheno_counter;
+    for (unsigned int row = 0; row < height; ++row) {
+        for (unsigned int col = 0; col < width; ++col) {
+            unsigned int pos = padded_index(row, col);
+            alive_counter.add(next_alive[pos]);
+            if (is_allele) {
+                dominant_counter.add(next_dominant[0][pos]);
+                dominant_counter.add(next_dominant[1][pos]);
+                pheno_counter.add(next_dominant[0][pos] |
+                                  next_dominant[1][pos]);
+            } // if
+        }     // for
+    }         // for
+    replicate_counts = ReplicateCounts();
+    alive_counter.add_to(replicate_counts.alive);
+    dominant_counter.add_to(replicate_counts.dominant);
+    pheno_counter.add_to(replicate_counts.dominant_pheno);
+    num_alive = 0;
+    for (unsigned int replicate = 0; replicate < replicates; ++replicate) {
+        num_alive += replicate_counts.alive[replicate];
+    } // for
+    wrap_halos();
+} // fill_grid()
+
+// update every replicate to the next generation
+void ModelEnsemble::update() {
+    current_alive.swap(next_alive);
+    current_dominant[0].swap(next_dominant[0]);
+    current_dominant[1].swap(next_dominant[1]);
+    ++generations;
+    // blocks of rows only read the current board and write their own rows
+    // of the next one
+    unsigned int blocks = static_cast<unsigned int>(block_counts.size());
+    if (is_allele) {
+        pool.run(blocks, [this](unsigned int block) {
+            step_block<true>(block);
+        });
+    } else {
+        pool.run(blocks, [this](unsigned int block) {
+            step_block<false>(block);
+        });
+    } // if/else
+
+    // add up the counts of every block
+    replicate_counts = ReplicateCounts();
+    num_alive = 0;
+    for (const ReplicateCounts &counts : block_counts) {
+        for (unsigned int replicate = 0; replicate < replicates;
+             ++replicate) {
+            replicate_counts.alive[replicate] += counts.alive[replicate];
+            replicate_counts.dominant[replicate] += counts.dominant[replicate];
+            replicate_counts.dominant_pheno[replicate] +=
+                    counts.dominant_pheno[replicate];
+            num_alive += counts.alive[replicate];
+        } // for
+    }     // for
+    wrap_halos();
+} // update()
+
+// step a block of rows into the next grid, counting each replicate's cells
+template <bool Allele>
+void ModelEnsemble::step_block(unsigned int block) {
+    LaneCounter alive_counter, dominant_counter, pheno_counter;
+    // every cell takes a pass over the terms, so keep them close
+    Rule::Term terms[Rule::MAX_NEIGHBORS + 1];
+    unsigned int term_count = 0;
+    for (const Rule::Term *term = rule.terms_begin();
+         term != rule.terms_end(); ++term) {
+        terms[term_count++] = *term;
+    } // for
+    // the neighbors of a cell, in scan order from northwest to southeast
+    int stride = static_cast<int>(width) + 2;
+    const int offsets[8]{-stride - 1, -stride, -stride + 1, -1,
+                         1,           stride - 1, stride,  stride + 1};
+    unsigned int row_end = std::min(height, (block + 1) * BLOCK_ROWS);
+    for (unsigned int row = block * BLOCK_ROWS; row < row_end; ++row) {
+        // the rows around the cell, from the ghost cell left of it
+        const std::uint64_t *middle =
+                &current_alive[padded_index(row, 0) - 1];
+        const std::uint64_t *above = middle - stride;
+        const std::uint64_t *below = middle + stride;
+        for (unsigned int col = 0; col < width; ++col) {
+            unsigned int pos = padded_index(row, col);
+            const std::uint64_t neighbors[8]{
+                    above[col],  above[col + 1], above[col + 2],
+                    middle[col], middle[col + 2], below[col],
+                    below[col + 1], below[col + 2]};
+            std::uint64_t alive = middle[col + 1];
+            BitGrid::NeighborCount count = BitGrid::add_neighbors(neighbors);
+            std::uint64_t next = 0;
+            for (unsigned int term = 0; term < term_count; ++term) {
+                next |= BitGrid::count_equals(count, terms[term].neighbors) &
+                        ((alive & terms[term].if_alive) |
+                         (~alive & terms[term].if_dead));
+            } // for
+            // every replicate draws from the same numbers for the cell, each
+            // from its own bit of them
+            CounterRandom random = cell_random(row * width + col);
+            if (!rule.is_deterministic()) {
+                std::uint64_t candidates =
+                        BitGrid::chance_births(count, alive, rule) &
+                        replicate_mask;
+                if (candidates != 0) {
+                    next |= roll_chance_births(count, candidates, random);
+                } // if
+            } // if
+            next &= replicate_mask;
+            next_alive[pos] = next;
+            alive_counter.add(next);
+            if (!Allele) {
+                continue;
+            } // if
+
+            // survivors keep their alleles, and newborns inherit theirs
+            std::uint64_t dominant[2];
+            for (int which = 0; which < 2; ++which) {
+                dominant[which] = current_dominant[which][pos] & next;
+            } // for
+            std::uint64_t births = next & ~alive;
+            if (births != 0) {
+                std::uint64_t dominant_neighbors[2][8];
+                for (int which = 0; which < 2; ++which) {
+                    const std::uint64_t *dominant_cell =
+                            &current_dominant[which][pos];
+                    for (int neighbor = 0; neighbor < 8; ++neighbor) {
+                        dominant_neighbors[which][neighbor] =
+                                dominant_cell[offsets[neighbor]];
+                    } // for
+                }     // for
+                inherit_alleles(neighbors, dominant_neighbors, births, random,
+                                dominant);
+            } // if
+            next_dominant[0][pos] = dominant[0];
+            next_dominant[1][pos] = dominant[1];
+            dominant_counter.add(dominant[0]);
+            dominant_counter.add(dominant[1]);
+            pheno_counter.add(dominant[0] | dominant[1]);
+        } // for
+    }     // for
+
+    ReplicateCounts &counts = block_counts[block];
+    counts = ReplicateCounts();
+    alive_counter.add_to(counts.alive);
+    dominant_counter.add_to(counts.dominant);
+    pheno_counter.add_to(counts.dominant_pheno);
+} // step_block()
+
+// the candidates born by chance, each lane rolling against the chance of its
+// own number of neighbors
+std::uint64_t
+ModelEnsemble::roll_chance_births(const BitGrid::NeighborCount &count,
+                                  std::uint64_t candidates,
+                                  CounterRandom &random) const {
+    // the lanes with each number of neighbors that has a chance
+    std::uint64_t lanes[Rule::MAX_NEIGHBORS + 1];
+    std::uint64_t thresholds[Rule::MAX_NEIGHBORS + 1];
+    unsigned int groups = 0;
+    std::uint64_t born = 0;
+    for (unsigned int neighbors = 0; neighbors <= Rule::MAX_NEIGHBORS;
+         ++neighbors) {
+        std::uint64_t group =
+                BitGrid::count_equals(count, neighbors) & candidates;
+        if (group == 0) {
+            continue;
+        } // if
+        if (chance_thresholds[neighbors] >> 32) {
+            // a certain birth needs no roll
+            born |= group;
+            candidates &= ~group;
+            continue;
+        } // if
+        lanes[groups] = group;
+        thresholds[groups++] = chance_thresholds[neighbors];
+    } // for
+
+    // compare a random 32 bit fraction in every lane against the lane's
+    // chance, a bit at a time from the top, until every lane is decided
+    for (int bit = 31; bit >= 0 && candidates != 0; --bit) {
+        std::uint64_t chance = 0;
+        for (unsigned int group = 0; group < groups; ++group) {
+            if ((thresholds[group] >> bit) & 1) {
+                chance |= lanes[group];
+            } // if
+        } // for
+        std::uint64_t roll = random.next();
+        roll = (roll << 32) | random.next();
+        // a lane is born where its roll first falls below its chance
+        born |= candidates & chance & ~roll;
+        candidates &= ~(chance ^ roll);
+    } // for
+    return born;
+} // roll_chance_births()
+
+// whether the alleles of each newborn, taken from its first two neighbors in
+// scan order or both from a lone neighbor, are dominant
+void ModelEnsemble::inherit_alleles(
+        const std::uint64_t neighbors[8],
+        const std::uint64_t dominant_neighbors[2][8], std::uint64_t births,
+        CounterRandom &random, std::uint64_t dominant[2]) {
+    // which allele each newborn takes from each parent
+    std::uint64_t chosen[2];
+    for (int which = 0; which < 2; ++which) {
+        chosen[which] = random.next();
+        chosen[which] = (chosen[which] << 32) | random.next();
+    } // for
+    // lanes still looking for their first and second parents
+    std::uint64_t first = births;
+    std::uint64_t second = 0;
+    // the alleles of the first parent, in case it is the only one
+    std::uint64_t lone = 0;
+    for (int neighbor = 0; neighbor < 8; ++neighbor) {
+        // the allele each lane would take from this neighbor as each parent
+        std::uint64_t allele[2];
+        for (int which = 0; which < 2; ++which) {
+            allele[which] = (chosen[which] &
+                             dominant_neighbors[1][neighbor]) |
+                            (~chosen[which] & dominant_neighbors[0][neighbor]);
+        } // for
+        std::uint64_t as_second = second & neighbors[neighbor];
+        std::uint64_t as_first = first & neighbors[neighbor];
+        dominant[1] |= as_second & allele[1];
+        dominant[0] |= as_first & allele[0];
+        lone |= as_first & allele[1];
+        second = (second & ~as_second) | as_first;
+        first &= ~as_first;
+    } // for
+    dominant[1] |= second & lone;
+} // inherit_alleles()
+
+// add the low planes into the wide planes and clear them
+void ModelEnsemble::LaneCounter::carry_low() {
+    std::uint64_t carry = 0;
+    for (unsigned int plane = 0; plane < 32; ++plane) {
+        std::uint64_t add = plane < 4 ? low[plane] : 0;
+        if (add == 0 && carry == 0 && plane >= 4) {
+            break;
+        } // if
+        std::uint64_t sum = planes[plane] ^ add ^ carry;
+        carry = (planes[plane] & add) | (carry & (planes[plane] ^ add));
+        planes[plane] = sum;
+    } // for
+    low[0] = low[1] = low[2] = low[3] = 0;
+    pending = 0;
+} // carry_low()
+
+// add the count of each lane to totals
+void ModelEnsemble::LaneCounter::add_to(unsigned int totals[MAX_REPLICATES]) {
+    carry_low();
+    for (unsigned int plane = 0; plane < 32; ++plane) {
+        for (std::uint64_t lanes = planes[plane]; lanes != 0;
+             lanes &= lanes - 1) {
+            totals[__builtin_ctzll(lanes)] += 1u << plane;
+        } // for
+    }     // for
+} // add_to()
+
+// copy the edges of the latest board into its ghost cells if the board wraps
+// around; otherwise they stay dead
+void ModelEnsemble::wrap_halos() {
+    if (toroidal) {
+        wrap_halo(next_alive);
+        if (is_allele) {
+            wrap_halo(next_dominant[0]);
+            wrap_halo(next_dominant[1]);
+        } // if
+    }     // if
+} // wrap_halos()
+
+// the names of the statistics of each replicate
+const char *ModelEnsemble::get_stats_header() const {
+    return is_allele ? ModelAllele::STATS_HEADER : ModelDefault::STATS_HEADER;
+} // get_stats_header()
+
+// the statistics of a replicate's latest board as a row of values under
+// get_stats_header()
+std::string ModelEnsemble::format_stats(unsigned int replicate) const {
+    unsigned int alive = replicate_counts.alive[replicate];
+    std::string row = std::to_string(generations);
+    row += ',';
+    if (!is_allele) {
+        row += std::to_string(alive);
+        return row;
+    } // if
+    unsigned int dominant = replicate_counts.dominant[replicate];
+    unsigned int dominant_pheno = replicate_counts.dominant_pheno[replicate];
+    row += std::to_string(static_cast<double>(dominant) /
+                          static_cast<double>(2 * alive));
+    row += ',';
+    row += std::to_string(static_cast<double>(2 * alive - dominant) /
+                          static_cast<double>(2 * alive));
+    row += ',';
+    row += std::to_string(static_cast<double>(dominant_pheno) /
+                          static_cast<double>(alive));
+    row += ',';
+    row += std::to_string(static_cast<double>(alive - dominant_pheno) /
+                          static_cast<double>(alive));
+    return row;
+} // format_stats()
+
+} // namespace GameOfLife
@@ -0,0 +1,150 @@
+/*
+ * ModelEnsemble.hpp
+ * Up to 64 replicates of the Default or Allele mode stepped together. Bit r
+ * of every cell's word belongs to replicate r, so one pass of the adders
+ * over a cell's neighbors steps the cell in every replicate at once, and
+ * bit r of every random word drawn for the cell is replicate r's own.
+ */
+
+#ifndef ModelEnsemble_hpp
+#define ModelEnsemble_hpp
+
+#include "BitGrid.hpp"
+#include "GridView.hpp"
+#include "Model.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace GameOfLife {
+
+class ModelEnsemble : public Model {
+public:
+    // construct an ensemble of replicates of the Default mode, or of the
+    // Allele mode if allele; replicate r starts from the board a model
+    // seeded with the seed of options plus r would. Throws
+    // std::invalid_argument unless 1 <= replicates <= MAX_REPLICATES
+    ModelEnsemble(unsigned int width, unsigned int height, double prob_alive,
+                  bool allele, double dom_frequency, unsigned int replicates,
+                  const ModelOptions &options);
+
+    // update every replicate to the next generation
+    void update() override;
+    // refill every replicate with new cells
+    void reset() override;
+
+    unsigned int get_replicates() const {
+        return replicates;
+    }
+    // the number of living cells of a replicate
+    unsigned int get_replicate_alive(unsigned int replicate) const {
+        return replicate_counts.alive[replicate];
+    }
+    // the names of the statistics of each replicate
+    const char *get_stats_header() const;
+    // the statistics of a replicate's latest board as a row of values under
+    // get_stats_header(), in the format of the replicate's game mode
+    std::string format_stats(unsigned int replicate) const;
+
+    // the latest cells, bit r of each word belonging to replicate r, valid
+    // until the ensemble is next stepped or reset
+    GridView<std::uint64_t> get_alive() const {
+        return GridView<std::uint64_t>(&next_alive[padded_index(0, 0)],
+                                       width, height, width + 2);
+    }
+    // whether the first or second allele of each latest cell is dominant
+    GridView<std::uint64_t> get_dominant(int allele) const {
+        return GridView<std::uint64_t>(
+                &next_dominant[allele][padded_index(0, 0)], width, height,
+                width + 2);
+    }
+
+    static constexpr unsigned int MAX_REPLICATES = 64;
+
+private:
+    // the numbers of living cells, dominant alleles and phenotypically
+    // dominant cells of each replicate
+    struct ReplicateCounts {
+        ReplicateCounts() : alive(), dominant(), dominant_pheno() {}
+
+        unsigned int alive[MAX_REPLICATES];
+        unsigned int dominant[MAX_REPLICATES];
+        unsigned int dominant_pheno[MAX_REPLICATES];
+    };
+
+    // the number of set bits in each of the 64 lanes of the words added,
+    // kept bit-sliced: words are added branch-free into four low planes,
+    // which are carried into the wide planes before they can overflow
+    struct LaneCounter {
+        LaneCounter() : low(), pending(0), planes() {}
+
+        // add one to the count of every lane set in word
+        void add(std::uint64_t word) {
+            for (int plane = 0; plane < 4; ++plane) {
+                std::uint64_t carry = low[plane] & word;
+                low[plane] ^= word;
+                word = carry;
+            } // for
+            if (++pending == LOW_LIMIT) {
+                carry_low();
+            } // if
+        }
+        // add the count of each lane to totals
+        void add_to(unsigned int totals[MAX_REPLICATES]);
+
+    private:
+        // add the low planes into the wide planes and clear them
+        void carry_low();
+
+        // four planes count up to 15 adds
+        static constexpr unsigned int LOW_LIMIT = 15;
+        std::uint64_t low[4];
+        unsigned int pending;
+        std::uint64_t planes[32];
+    };
+
+    // fill every replicate with random cells
+    void fill_grid();
+    // step a block of rows into the next grid, counting each replicate's
+    // cells; specialized on the game mode
+    template <bool Allele>
+    void step_block(unsigned int block);
+    // the candidates born by chance, each lane rolling against the chance
+    // of its own number of neighbors
+    std::uint64_t roll_chance_births(const BitGrid::NeighborCount &count,
+                                     std::uint64_t candidates,
+                                     CounterRandom &random) const;
+    // whether the alleles of each newborn, taken from its first two
+    // neighbors in scan order or both from a lone neighbor, are dominant
+    static void inherit_alleles(const std::uint64_t neighbors[8],
+                                const std::uint64_t dominant_neighbors[2][8],
+                                std::uint64_t births, CounterRandom &random,
+                                std::uint64_t dominant[2]);
+    // copy the edges of the latest board into its ghost cells if the board
+    // wraps around
+    void wrap_halos();
+
+    bool is_allele;
+    double dom_frequency; // initial frequency of dominant alleles
+    unsigned int replicates;
+    // the lanes of the replicates in use
+    std::uint64_t replicate_mask;
+    // the chance of a birth by chance with each number of neighbors, as a
+    // fraction of 2^32
+    std::uint64_t chance_thresholds[Rule::MAX_NEIGHBORS + 1];
+
+    // the board, one word per cell indexed by padded_index(), and for the
+    // Allele mode whether each allele of each cell is dominant
+    std::vector<std::uint64_t> current_alive;
+    std::vector<std::uint64_t> next_alive;
+    std::vector<std::uint64_t> current_dominant[2];
+    std::vector<std::uint64_t> next_dominant[2];
+
+    // counts of each block of rows, and of the whole board
+    std::vector<ReplicateCounts> block_counts;
+    ReplicateCounts replicate_counts;
+    static constexpr unsigned int BLOCK_ROWS = 8;
+};
+
+} // namespace GameOfLife
+#endif /* ModelEnsemble_hpp */
@@ -0,0 +1,98 @@
+/*
+ * MutationSampler.cpp
+ * Draws how far a color channel mutates. A channel that can move n values
+ * mutates with a chance set by the mutation rate, and then moves k of them
+ * with probability roughly proportional to 1/k^2; the sizes are drawn from
+ * alias tables, one per value of n, so a mutation costs a table lookup.
+ */
+
+#include "MutationSampler.hpp"
+#include <cstddef>
+#include <initializer_list>
+
+namespace GameOfLife {
+
+// the sampler shared by every model, built the first time it's needed
+const MutationSampler &MutationSampler::get() {
+    static const MutationSampler sampler;
+    return sampler;
+} // get()
+
+// build the tables for every headroom and value
+MutationSampler::MutationSampler()
+        : raise_sizes(MAX_CHANNEL + 1), lower_sizes(MAX_CHANNEL + 1) {
+    for (unsigned int n = 2; n <= MAX_CHANNEL; ++n) {
+        // a raise picks a whole number j from 1 to n evenly and moves n / j
+        std::vector<double> raise_weights(n + 1, 0.0);
+        for (unsigned int j = 1; j <= n; ++j) {
+            raise_weights[n / j] += 1.0 / n;
+        } // for
+        raise_sizes[n] = build_table(raise_weights);
+
+        // a drop picks a real number u from 1 to n evenly and moves
+        // floor(n / u), so it moves k with chance n / ((n - 1) k (k + 1))
+        std::vector<double> lower_weights(n, 0.0);
+        for (unsigned int k = 1; k < n; ++k) {
+            lower_weights[k] = n / ((n - 1.0) * k * (k + 1.0));
+        } // for
+        lower_sizes[n] = build_table(lower_weights);
+    } // for
+} // MutationSampler()
+
+// an alias table drawing size s with probability weights[s], by Vose's method
+MutationSampler::AliasTable
+MutationSampler::build_table(const std::vector<double> &weights) {
+    AliasTable table;
+    std::vector<double> scaled;
+    for (std::size_t size = 0; size < weights.size(); ++size) {
+        if (weights[size] > 0) {
+            table.push_back(Entry{0, static_cast<std::uint8_t>(size), 0});
+            scaled.push_back(weights[size]);
+        } // if
+    }     // for
+    // scale so the average column holds exactly one
+    double total = 0;
+    for (double weight : scaled) {
+        total += weight;
+    } // for
+    std::vector<std::size_t> small, large;
+    for (std::size_t column = 0; column < scaled.size(); ++column) {
+        scaled[column] *= static_cast<double>(scaled.size()) / total;
+        (scaled[column] < 1 ? small : large).push_back(column);
+    } // for
+    // top up each column short of one with part of a column over one
+    while (!small.empty() && !large.empty()) {
+        std::size_t short_column = small.back();
+        std::size_t long_column = large.back();
+        small.pop_back();
+        table[short_column].threshold =
+                static_cast<std::uint32_t>(scaled[short_column] * 4294967296.0);
+        table[short_column].alias = table[long_column].size;
+        scaled[long_column] -= 1 - scaled[short_column];
+        if (scaled[long_column] < 1) {
+            large.pop_back();
+            small.push_back(long_column);
+        } // if
+    }     // while
+    // whatever is left holds one up to rounding, so it's its own alias
+    for (std::vector<std::size_t> *rest : {&small, &large}) {
+        for (std::size_t column : *rest) {
+            table[column].threshold = UINT32_MAX;
+            table[column].alias = table[column].size;
+        } // for
+    }     // for
+    return table;
+} // build_table()
+
+// draw a raise with a uniform number when the tables don't apply: a whole
+// number j is picked from 1 to 1 + (headroom - 1) / rate, and the channel is
+// raised headroom / j if j is at most headroom
+unsigned int MutationSampler::raise_directly(unsigned int headroom,
+                                             double mutation_rate,
+                                             CounterRandom &random) {
+    double range = (headroom - 1) / mutation_rate;
+    unsigned int j = static_cast<unsigned int>(random.uniform(1, 1 + range));
+    return j > headroom ? 0 : headroom / j;
+} // raise_directly()
+
+} // namespace GameOfLife
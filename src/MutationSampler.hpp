@@ -0,0 +1,93 @@
+/*
+ * MutationSampler.hpp
+ * Draws how far a color channel mutates. A channel that can move n values
+ * mutates with a chance set by the mutation rate, and then moves k of them
+ * with probability roughly proportional to 1/k^2; the sizes are drawn from
+ * alias tables, one per value of n, so a mutation costs a table lookup.
+ */
+
+#ifndef MutationSampler_hpp
+#define MutationSampler_hpp
+
+#include "CounterRandom.hpp"
+#include <cstdint>
+#include <stdio.h>
+#include <vector>
+
+namespace GameOfLife {
+
+class MutationSampler {
+public:
+    // the sampler shared by every model, built the first time it's needed
+    static const MutationSampler &get();
+
+    // how far to raise a channel with headroom values above it; chance_bits
+    // are 31 random bits deciding whether it mutates at all
+    unsigned int raise(unsigned int headroom, double mutation_rate,
+                       std::uint32_t chance_bits, CounterRandom &random) const {
+        // a raise of headroom n happens with chance n * rate / (n - 1), and
+        // higher chances fall back on drawing the size directly
+        double chance = mutation_rate * headroom / (headroom - 1.0);
+        if (headroom == 1 || chance >= 1) {
+            return raise_directly(headroom, mutation_rate, random);
+        } else if (chance_bits >= chance * CHANCE_SCALE) {
+            return 0;
+        } // if
+        return sample(raise_sizes[headroom], random.next());
+    }
+
+    // how far to lower a channel with value values below it; chance_bits are
+    // 31 random bits deciding whether it mutates at all
+    unsigned int lower(unsigned int value, double mutation_rate,
+                       std::uint32_t chance_bits, CounterRandom &random) const {
+        // a channel at 1 always drops to 0
+        if (value == 1) {
+            return 1;
+        } else if (chance_bits >= mutation_rate * CHANCE_SCALE) {
+            return 0;
+        } // if
+        return sample(lower_sizes[value], random.next());
+    }
+
+private:
+    // one column of an alias table: the column's own size is drawn if the
+    // coin lands under threshold, otherwise its alias
+    struct Entry {
+        std::uint32_t threshold;
+        std::uint8_t size;
+        std::uint8_t alias;
+    };
+    typedef std::vector<Entry> AliasTable;
+
+    // build the tables for every headroom and value
+    MutationSampler();
+
+    // an alias table drawing size s with probability weights[s]
+    static AliasTable build_table(const std::vector<double> &weights);
+    // draw from an alias table with one random word: its high bits pick the
+    // column and its low bits flip the coin
+    static unsigned int sample(const AliasTable &table, std::uint32_t word) {
+        std::uint64_t product =
+                static_cast<std::uint64_t>(word) * table.size();
+        const Entry &entry = table[product >> 32];
+        return static_cast<std::uint32_t>(product) < entry.threshold
+                       ? entry.size
+                       : entry.alias;
+    }
+    // draw a raise with a uniform number when the tables don't apply
+    static unsigned int raise_directly(unsigned int headroom,
+                                       double mutation_rate,
+                                       CounterRandom &random);
+
+    // the size of a raise given that it happens, by headroom
+    std::vector<AliasTable> raise_sizes;
+    // the size of a drop given that it happens, by value
+    std::vector<AliasTable> lower_sizes;
+
+    // 2^31, for comparing chances with 31 random bits
+    static constexpr double CHANCE_SCALE = 2147483648.0;
+    static constexpr unsigned int MAX_CHANNEL = 0xFF;
+};
+
+} // namespace GameOfLife
+#endif /* MutationSampler_hpp */
@@ -0,0 +1,112 @@
+/*
+ * PhaseTimers.cpp
+ * Times where each frame goes: stepping the board, computing and recording
+ * its statistics, and drawing it.
+ */
+
+#include "PhaseTimers.hpp"
+#include <algorithm>
+#include <cstdio>
+
+namespace GameOfLife {
+
+// the names of the phases in a summary
+static const char *PHASE_NAMES[PhaseTimers::PHASES] = {
+        "other", "step", "stats", "record", "texture", "draw"};
+
+thread_local PhaseTimers::Clock::duration ScopedPhase::nested{};
+
+// construct timers that are off
+PhaseTimers::PhaseTimers()
+        : enabled(false), start(), last_summary(), last_generations(0),
+          totals(), summary(), log() {
+    for (std::atomic<std::int64_t> &total : totals) {
+        total.store(0);
+    } // for
+} // PhaseTimers()
+
+// start or stop timing
+void PhaseTimers::set_enabled(bool enabled_) {
+    if (enabled_ && !is_enabled()) {
+        start = last_summary = Clock::now();
+        for (std::atomic<std::int64_t> &total : totals) {
+            total.store(0);
+        } // for
+    } // if
+    enabled.store(enabled_);
+} // set_enabled()
+
+// also write each summary as a row of files named log_file_name_N.csv
+void PhaseTimers::set_log(const std::string &log_file_name) {
+    log.reset(new Recorder(log_file_name, LOG_HEADER));
+    log->toggle_recording();
+} // set_log()
+
+// summarize the time since the last summary if a second has passed
+void PhaseTimers::tick(std::uint64_t generations, std::uint64_t cells) {
+    if (enabled && Clock::now() - last_summary >= std::chrono::seconds(1)) {
+        summarize(generations, cells);
+    } // if
+} // tick()
+
+// summarize the time since the last summary now
+void PhaseTimers::summarize(std::uint64_t generations, std::uint64_t cells) {
+    if (!is_enabled()) {
+        return;
+    } // if
+    Clock::time_point now = Clock::now();
+    double seconds = std::chrono::duration<double>(now - last_summary).count();
+    if (seconds <= 0.0) {
+        return;
+    } // if
+    // the time outside every phase is what's left of the time since the
+    // last summary; phases timed side by side on different threads can
+    // leave none
+    double phase_seconds[PHASES];
+    double covered = 0.0;
+    for (int phase = STEP; phase < PHASES; ++phase) {
+        phase_seconds[phase] =
+                1e-9 * static_cast<double>(totals[phase].exchange(0));
+        covered += phase_seconds[phase];
+    } // for
+    phase_seconds[OTHER] = std::max(0.0, seconds - covered);
+    // a reset starts the count of generations over
+    std::uint64_t stepped = generations >= last_generations
+                                    ? generations - last_generations
+                                    : generations;
+    // milliseconds per generation, or per second while paused
+    double per = stepped > 0 ? static_cast<double>(stepped) : seconds;
+    double rate = static_cast<double>(stepped) / seconds;
+    double cell_rate = rate * static_cast<double>(cells);
+
+    char buffer[64];
+    summary.clear();
+    for (int phase = STEP; phase < PHASES; ++phase) {
+        std::snprintf(buffer, sizeof(buffer), "%s: %.2f ms, ",
+                      PHASE_NAMES[phase], 1000.0 * phase_seconds[phase] / per);
+        summary += buffer;
+    } // for
+    std::snprintf(buffer, sizeof(buffer), "%.0f gen/s, %.3g cells/s", rate,
+                  cell_rate);
+    summary += buffer;
+
+    if (log) {
+        std::string row =
+                std::to_string(
+                        std::chrono::duration<double>(now - start).count()) +
+                ',' + std::to_string(generations) + ',' +
+                std::to_string(rate) + ',' + std::to_string(cell_rate);
+        for (int phase = STEP; phase < PHASES; ++phase) {
+            row += ',';
+            row += std::to_string(1000.0 * phase_seconds[phase] / per);
+        } // for
+        row += ',';
+        row += std::to_string(1000.0 * phase_seconds[OTHER] / per);
+        log->write_row(row);
+    } // if
+
+    last_summary = now;
+    last_generations = generations;
+} // summarize()
+
+} // namespace GameOfLife
@@ -0,0 +1,114 @@
+/*
+ * PhaseTimers.hpp
+ * Times where each frame goes: stepping the board, computing and recording
+ * its statistics, and drawing it. A phase entered inside another on the same
+ * thread pauses it, while phases on different threads, such as stepping the
+ * board and drawing it, are timed side by side. The totals are summarized
+ * about once a second as milliseconds per generation. Timers that are off
+ * cost a single check per phase.
+ */
+
+#ifndef PhaseTimers_hpp
+#define PhaseTimers_hpp
+
+#include "Recorder.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <stdio.h>
+#include <string>
+
+namespace GameOfLife {
+
+class PhaseTimers {
+public:
+    // where the time goes; OTHER is the time outside every phase, such as
+    // handling events and waiting for the next frame
+    enum Phase { OTHER, STEP, STATS, RECORD, TEXTURE, DRAW, PHASES };
+    typedef std::chrono::steady_clock Clock;
+
+    PhaseTimers();
+
+    // start or stop timing; timers start off
+    void set_enabled(bool enabled_);
+    bool is_enabled() const {
+        return enabled.load(std::memory_order_relaxed);
+    }
+    // also write each summary as a row of files named log_file_name_N.csv
+    void set_log(const std::string &log_file_name);
+
+    // charge time to phase; safe to call from any thread
+    void add(Phase phase, Clock::duration time) {
+        totals[phase].fetch_add(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(time)
+                        .count(),
+                std::memory_order_relaxed);
+    }
+    // summarize the time since the last summary if a second has passed,
+    // given the generations the model has reached and its number of cells
+    void tick(std::uint64_t generations, std::uint64_t cells);
+    // summarize the time since the last summary now; tick() and summarize()
+    // are only called from one thread
+    void summarize(std::uint64_t generations, std::uint64_t cells);
+    // the latest summary, such as "step: 1.20 ms, ..., 60 gen/s"
+    const std::string &get_summary() const {
+        return summary;
+    }
+
+    // the names of the phases and rates in each row of the log
+    static constexpr const char *LOG_HEADER =
+            "Seconds,Generation,Generations/s,Cells/s,Step ms,Stats ms,"
+            "Record ms,Texture ms,Draw ms,Other ms";
+
+private:
+    std::atomic<bool> enabled;
+    // when timing started, and when the totals were last summarized
+    Clock::time_point start;
+    Clock::time_point last_summary;
+    std::uint64_t last_generations;
+    // nanoseconds in each phase since the last summary
+    std::atomic<std::int64_t> totals[PHASES];
+    std::string summary;
+    std::unique_ptr<Recorder> log;
+};
+
+// charges the time from its construction to its destruction to a phase, less
+// the time of phases entered inside it on the same thread, or does nothing
+// if the timers are null or off
+class ScopedPhase {
+public:
+    ScopedPhase(PhaseTimers *timers, PhaseTimers::Phase phase)
+            : timers(timers != nullptr && timers->is_enabled() ? timers
+                                                               : nullptr),
+              phase(phase), start(), nested_before() {
+        if (this->timers != nullptr) {
+            start = PhaseTimers::Clock::now();
+            nested_before = nested;
+        } // if
+    }
+    ~ScopedPhase() {
+        if (timers != nullptr) {
+            PhaseTimers::Clock::duration elapsed =
+                    PhaseTimers::Clock::now() - start;
+            timers->add(phase, elapsed - (nested - nested_before));
+            nested = nested_before + elapsed;
+        } // if
+    }
+    ScopedPhase(const ScopedPhase &) = delete;
+    ScopedPhase &operator=(const ScopedPhase &) = delete;
+
+private:
+    PhaseTimers *timers;
+    PhaseTimers::Phase phase;
+    PhaseTimers::Clock::time_point start;
+    // the time of the phases finished on this thread when this one started;
+    // the phases entered inside it took whatever's been added since
+    PhaseTimers::Clock::duration nested_before;
+    // the time of every outermost phase finished on each thread so far,
+    // counting the phases entered inside them once
+    static thread_local PhaseTimers::Clock::duration nested;
+};
+
+} // namespace GameOfLife
+#endif /* PhaseTimers_hpp */
@@ -0,0 +1,201 @@
+/*
+ * PixelsCore.cpp
+ * A C interface to the simulation core, for embedding the models without a
+ * display. Boards are read in place through grid views, which stay valid
+ * until the model is next stepped or reset.
+ */
+
+#include "PixelsCore.h"
+#include "ModelAllele.hpp"
+#include "ModelAverage.hpp"
+#include "ModelDefault.hpp"
+#include <memory>
+
+using namespace GameOfLife;
+
+// a model of any game mode, with a pointer to it as its own mode
+struct pixels_model {
+    std::unique_ptr<Model> model;
+    ModelDefault *model_default;
+    ModelAverage *model_average;
+    ModelAllele *model_allele;
+};
+
+namespace {
+
+// convert options for the C++ models, where NULL means the defaults
+ModelOptions to_model_options(const pixels_options *options) {
+    ModelOptions out;
+    if (options != nullptr) {
+        out.seed = options->seed;
+        out.threads = options->threads;
+        out.rule = options->rule != nullptr ? options->rule : "";
+        out.toroidal = options->toroidal != 0;
+    } // if
+    return out;
+} // to_model_options()
+
+// whether the rule of options gives birth without neighbors, which leaves
+// newborn cells without parents
+bool births_without_parents(const ModelOptions &options) {
+    return !options.rule.empty() &&
+           Rule(options.rule).births_without_neighbors();
+} // births_without_parents()
+
+// a view of a packed board
+pixels_grid_view bits_view(const BitGrid &grid) {
+    pixels_grid_view view;
+    view.data = grid.row_data(0);
+    view.format = PIXELS_BITS;
+    view.width = grid.get_width();
+    view.height = grid.get_height();
+    view.stride = grid.get_stride();
+    return view;
+} // bits_view()
+
+// a view of a board of one value per cell
+template <typename T>
+pixels_grid_view values_view(const GridView<T> &grid, pixels_format format) {
+    pixels_grid_view view;
+    view.data = grid.data;
+    view.format = format;
+    view.width = grid.width;
+    view.height = grid.height;
+    view.stride = grid.stride;
+    return view;
+} // values_view()
+
+} // namespace
+
+extern "C" {
+
+// the default settings, with a random seed
+pixels_options pixels_default_options(void) {
+    ModelOptions defaults;
+    pixels_options options;
+    options.seed = defaults.seed;
+    options.threads = defaults.threads;
+    options.rule = nullptr;
+    options.toroidal = defaults.toroidal;
+    return options;
+} // pixels_default_options()
+
+// create a model of the default game mode
+pixels_model *pixels_create_default(unsigned int width, unsigned int height,
+                                    double prob_alive,
+                                    const pixels_options *options) {
+    try {
+        std::unique_ptr<pixels_model> out(new pixels_model());
+        out->model_default = new ModelDefault(width, height, prob_alive,
+                                              to_model_options(options),
+                                              nullptr);
+        out->model.reset(out->model_default);
+        return out.release();
+    } catch (...) {
+        return nullptr;
+    } // try/catch
+} // pixels_create_default()
+
+// create a model of the average game mode
+pixels_model *pixels_create_average(unsigned int width, unsigned int height,
+                                    double prob_alive, int sexual,
+                                    double min_mutation, double max_mutation,
+                                    unsigned int ideal_color,
+                                    const pixels_options *options) {
+    try {
+        ModelOptions model_options = to_model_options(options);
+        if (births_without_parents(model_options)) {
+            return nullptr;
+        } // if
+        std::unique_ptr<pixels_model> out(new pixels_model());
+        out->model_average = new ModelAverage(
+                width, height, prob_alive, sexual != 0, min_mutation,
+                max_mutation, ideal_color, model_options, nullptr, "");
+        out->model.reset(out->model_average);
+        return out.release();
+    } catch (...) {
+        return nullptr;
+    } // try/catch
+} // pixels_create_average()
+
+// create a model of the allele game mode
+pixels_model *pixels_create_allele(unsigned int width, unsigned int height,
+                                   double prob_alive, double dom_frequency,
+                                   const pixels_options *options) {
+    try {
+        ModelOptions model_options = to_model_options(options);
+        if (births_without_parents(model_options)) {
+            return nullptr;
+        } // if
+        std::unique_ptr<pixels_model> out(new pixels_model());
+        out->model_allele = new ModelAllele(width, height, prob_alive,
+                                            dom_frequency, model_options,
+                                            nullptr, "");
+        out->model.reset(out->model_allele);
+        return out.release();
+    } catch (...) {
+        return nullptr;
+    } // try/catch
+} // pixels_create_allele()
+
+void pixels_destroy(pixels_model *model) {
+    delete model;
+} // pixels_destroy()
+
+// advance the model the given number of generations
+void pixels_step(pixels_model *model, uint64_t generations) {
+    for (uint64_t generation = 0; generation < generations; ++generation) {
+        model->model->update();
+    } // for
+} // pixels_step()
+
+// fill the board with new cells
+void pixels_reset(pixels_model *model) {
+    model->model->reset();
+} // pixels_reset()
+
+// read a board of the model in place
+int pixels_get_grid(const pixels_model *model, pixels_plane plane,
+                    pixels_grid_view *view) {
+    if (model->model_default != nullptr && plane == PIXELS_ALIVE) {
+        *view = bits_view(model->model_default->get_grid());
+    } else if (model->model_allele != nullptr && plane == PIXELS_ALIVE) {
+        *view = bits_view(model->model_allele->get_alive());
+    } else if (model->model_allele != nullptr &&
+               (plane == PIXELS_DOMINANT_1 || plane == PIXELS_DOMINANT_2)) {
+        *view = bits_view(model->model_allele->get_dominant(
+                plane == PIXELS_DOMINANT_1 ? 0 : 1));
+    } else if (model->model_average != nullptr && plane == PIXELS_COLOR) {
+        *view = values_view(model->model_average->get_colors(), PIXELS_U32);
+    } else if (model->model_average != nullptr &&
+               plane == PIXELS_MUTATION_RATE) {
+        *view = values_view(model->model_average->get_mutation_rates(),
+                            PIXELS_F32);
+    } else {
+        return 1;
+    } // if
+    return 0;
+} // pixels_get_grid()
+
+// read the statistics of the latest board
+void pixels_get_stats(const pixels_model *model, pixels_stats *stats) {
+    *stats = pixels_stats();
+    stats->generations = model->model->get_generations();
+    stats->num_alive = model->model->get_num_alive();
+    // frequencies of an empty board are left at zero
+    if (stats->num_alive == 0) {
+        return;
+    } // if
+    if (model->model_average != nullptr) {
+        stats->average_fitness = model->model_average->calc_average_fitness();
+        stats->fitness_deviation =
+                model->model_average->calc_fitness_deviation();
+        stats->average_mutation_rate =
+                model->model_average->calc_average_mutation_rate();
+    } else if (model->model_allele != nullptr) {
+        stats->dominant_freq = model->model_allele->calc_dominant_freq();
+        stats->dominant_pheno = model->model_allele->calc_dominant_pheno();
+    } // if
+} // pixels_get_stats()
+
+} // extern "C"
@@ -0,0 +1,98 @@
+/*
+ * PixelsCore.h
+ * A C interface to the simulation core, for embedding the models without a
+ * display. Boards are read in place through grid views, which stay valid
+ * until the model is next stepped or reset.
+ */
+
+#ifndef PixelsCore_h
+#define PixelsCore_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct pixels_model pixels_model;
+
+/* settings shared by every game mode; see pixels_default_options() */
+typedef struct pixels_options {
+    uint64_t seed;
+    unsigned int threads; /* zero for one per hardware thread */
+    const char *rule;     /* B/S notation, or NULL for the mode's own */
+    int toroidal;         /* nonzero if the board wraps around */
+} pixels_options;
+
+/* the layouts of the boards a model stores */
+typedef enum pixels_format {
+    PIXELS_BITS, /* uint64_t words, bit col % 64 of word col / 64 */
+    PIXELS_U32,  /* one uint32_t per cell */
+    PIXELS_F32   /* one float per cell */
+} pixels_format;
+
+/* the boards a model may store */
+typedef enum pixels_plane {
+    PIXELS_ALIVE,        /* Default and Allele, PIXELS_BITS */
+    PIXELS_DOMINANT_1,   /* Allele, PIXELS_BITS */
+    PIXELS_DOMINANT_2,   /* Allele, PIXELS_BITS */
+    PIXELS_COLOR,        /* Average, PIXELS_U32 0xRRGGBB, 0 if dead */
+    PIXELS_MUTATION_RATE /* Average, PIXELS_F32 */
+} pixels_plane;
+
+/* a board stored by a model, read in place */
+typedef struct pixels_grid_view {
+    const void *data; /* the first element of the first row */
+    pixels_format format;
+    unsigned int width;
+    unsigned int height;
+    size_t stride; /* elements from one row to the next */
+} pixels_grid_view;
+
+/* statistics of the latest board; those a mode doesn't track are zero */
+typedef struct pixels_stats {
+    uint64_t generations;
+    unsigned int num_alive;
+    double average_fitness;       /* Average */
+    double fitness_deviation;     /* Average */
+    double average_mutation_rate; /* Average */
+    double dominant_freq;         /* Allele, of alleles */
+    double dominant_pheno;        /* Allele, of cells */
+} pixels_stats;
+
+/* the default settings, with a random seed */
+pixels_options pixels_default_options(void);
+
+/* create a model of each game mode, or return NULL if the settings are
+ * invalid; options may be NULL for the defaults */
+pixels_model *pixels_create_default(unsigned int width, unsigned int height,
+                                    double prob_alive,
+                                    const pixels_options *options);
+pixels_model *pixels_create_average(unsigned int width, unsigned int height,
+                                    double prob_alive, int sexual,
+                                    double min_mutation, double max_mutation,
+                                    unsigned int ideal_color,
+                                    const pixels_options *options);
+pixels_model *pixels_create_allele(unsigned int width, unsigned int height,
+                                   double prob_alive, double dom_frequency,
+                                   const pixels_options *options);
+void pixels_destroy(pixels_model *model);
+
+/* advance the model the given number of generations */
+void pixels_step(pixels_model *model, uint64_t generations);
+/* fill the board with new cells */
+void pixels_reset(pixels_model *model);
+
+/* read a board of the model in place, returning zero, or nonzero if the
+ * model doesn't store that board */
+int pixels_get_grid(const pixels_model *model, pixels_plane plane,
+                    pixels_grid_view *view);
+/* read the statistics of the latest board */
+void pixels_get_stats(const pixels_model *model, pixels_stats *stats);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* PixelsCore_h */
@@ -0,0 +1,65 @@
+/*
+ * Recorder.cpp
+ * Records the statistics of each generation as rows of a CSV file. Rows are
+ * buffered and written in large pieces, and each time recording starts a new
+ * file is opened, so a model can record with or without a window.
+ */
+
+#include "Recorder.hpp"
+#include <cassert>
+#include <iostream>
+
+namespace GameOfLife {
+
+// record rows under header to files named output_file_name_N.csv
+Recorder::Recorder(std::string output_file_name, std::string header)
+        : output_file_name(output_file_name), header(header), output_file(),
+          to_write(), extension_num(0), is_recording(false) {
+    to_write.reserve(WRITE_DELTA);
+} // Recorder()
+
+// write any remaining rows to the file
+Recorder::~Recorder() {
+    flush();
+    output_file.close();
+} // ~Recorder()
+
+// start recording to a new file, or stop recording
+void Recorder::toggle_recording() {
+    flush();
+    is_recording = !is_recording;
+    if (is_recording) {
+        output_file.close();
+        std::string name = output_file_name;
+        name += '_';
+        name += std::to_string(extension_num);
+        name += ".csv";
+        std::cout << name << std::endl;
+        output_file.open(name, std::fstream::out);
+        if (!output_file.is_open()) {
+            assert(false);
+        } // if
+        to_write += header;
+        to_write += '\n';
+        ++extension_num;
+    } // if
+} // toggle_recording()
+
+// add a row of comma separated values to the file
+void Recorder::write_row(const std::string &row) {
+    to_write += row;
+    to_write += '\n';
+    if (to_write.size() >= WRITE_DELTA) {
+        flush();
+    } // if
+} // write_row()
+
+// write the buffered rows to the file
+void Recorder::flush() {
+    if (output_file.is_open()) {
+        output_file << to_write;
+    } // if
+    to_write.clear();
+} // flush()
+
+} // namespace GameOfLife
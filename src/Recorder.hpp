@@ -0,0 +1,46 @@
+/*
+ * Recorder.hpp
+ * Records the statistics of each generation as rows of a CSV file. Rows are
+ * buffered and written in large pieces, and each time recording starts a new
+ * file is opened, so a model can record with or without a window.
+ */
+
+#ifndef Recorder_hpp
+#define Recorder_hpp
+
+#include <fstream>
+#include <stdio.h>
+#include <string>
+
+namespace GameOfLife {
+
+class Recorder {
+public:
+    // record rows under header to files named output_file_name_N.csv
+    Recorder(std::string output_file_name, std::string header);
+    // write any remaining rows to the file
+    ~Recorder();
+
+    // start recording to a new file, or stop recording
+    void toggle_recording();
+    bool get_is_recording() const {
+        return is_recording;
+    }
+    // add a row of comma separated values to the file
+    void write_row(const std::string &row);
+
+private:
+    // write the buffered rows to the file
+    void flush();
+
+    std::string output_file_name;
+    std::string header;
+    std::ofstream output_file;
+    std::string to_write;
+    int extension_num;
+    bool is_recording;
+    static constexpr unsigned int WRITE_DELTA = 1000;
+};
+
+} // namespace GameOfLife
+#endif /* Recorder_hpp */
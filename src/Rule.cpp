@@ -0,0 +1,117 @@
+/*
+ * Rule.cpp
+ * A life-like rule in B/S notation, compiled into lookup tables for stepping
+ * cells one at a time and into count terms for stepping packed words.
+ */
+
+#include "Rule.hpp"
+#include <cctype>
+#include <sstream>
+#include <stdexcept>
+
+namespace GameOfLife {
+
+// parse a rule such as "B3/S23", optionally followed by births that only happen
+// by chance such as "/P2=0.1,6=0.05"
+Rule::Rule(const std::string &notation_)
+        : birth_mask(0), survival_mask(0), chance_mask(0), chances(),
+          table(), terms(), term_count(0), notation() {
+    // ignore case and whitespace
+    for (char c : notation_) {
+        if (!std::isspace(static_cast<unsigned char>(c))) {
+            notation.push_back(static_cast<char>(
+                    std::toupper(static_cast<unsigned char>(c))));
+        } // if
+    }     // for
+
+    bool has_births = false, has_survivals = false;
+    std::stringstream segments(notation);
+    std::string segment;
+    while (std::getline(segments, segment, '/')) {
+        if (segment.empty()) {
+            throw std::invalid_argument("empty part in rule " + notation);
+        } else if (segment[0] == 'B' && !has_births) {
+            birth_mask = parse_counts(segment.substr(1));
+            has_births = true;
+        } else if (segment[0] == 'S' && !has_survivals) {
+            survival_mask = parse_counts(segment.substr(1));
+            has_survivals = true;
+        } else if (segment[0] == 'P' && chance_mask == 0) {
+            // comma separated births by chance, "neighbors=chance"
+            std::stringstream births(segment.substr(1));
+            std::string birth;
+            while (std::getline(births, birth, ',')) {
+                std::size_t equals = birth.find('=');
+                if (equals != 1) {
+                    throw std::invalid_argument("bad chance birth in rule " +
+                                                notation);
+                } // if
+                std::uint16_t count = parse_counts(birth.substr(0, equals));
+                std::size_t used = 0;
+                double chance = std::stod(birth.substr(equals + 1), &used);
+                if (used != birth.size() - equals - 1 || chance < 0 ||
+                    chance > 1 || (count & (chance_mask | birth_mask))) {
+                    throw std::invalid_argument("bad chance birth in rule " +
+                                                notation);
+                } // if
+                chance_mask = static_cast<std::uint16_t>(chance_mask | count);
+                chances[__builtin_ctz(count)] = chance;
+            } // while
+        } else {
+            throw std::invalid_argument("unexpected part in rule " +
+                                        notation);
+        } // if
+    }     // while
+    if (!has_births || !has_survivals || (birth_mask & chance_mask)) {
+        throw std::invalid_argument("rule needs births and survivals: " +
+                                    notation);
+    } // if
+
+    // one table entry per state and number of neighbors
+    for (int neighbors = 0; neighbors <= MAX_NEIGHBORS; ++neighbors) {
+        if ((birth_mask >> neighbors) & 1) {
+            table[0][neighbors] = LIVES;
+        } else if ((chance_mask >> neighbors) & 1) {
+            table[0][neighbors] = CHANCE;
+        } else {
+            table[0][neighbors] = DIES;
+        } // if
+        table[1][neighbors] = (survival_mask >> neighbors) & 1 ? LIVES : DIES;
+    } // for
+
+    // one term per number of neighbors that leaves any cell alive
+    for (unsigned int neighbors = 0; neighbors <= MAX_NEIGHBORS;
+         ++neighbors) {
+        bool born = (birth_mask >> neighbors) & 1;
+        bool survives = (survival_mask >> neighbors) & 1;
+        if (born || survives) {
+            terms[term_count++] = Term{neighbors, born ? ~std::uint64_t{0} : 0,
+                                       survives ? ~std::uint64_t{0} : 0};
+        } // if
+    }     // for
+} // Rule()
+
+// return whether notation is a rule that can be parsed
+bool Rule::is_valid(const std::string &notation) {
+    try {
+        Rule rule(notation);
+    } catch (const std::exception &) {
+        return false;
+    } // try/catch
+    return true;
+} // is_valid()
+
+// read a list of neighbor counts such as "23" into a mask
+std::uint16_t Rule::parse_counts(const std::string &counts) {
+    std::uint16_t mask = 0;
+    for (char c : counts) {
+        if (c < '0' || c > '0' + MAX_NEIGHBORS) {
+            throw std::invalid_argument("bad neighbor count in rule: " +
+                                        counts);
+        } // if
+        mask = static_cast<std::uint16_t>(mask | (1u << (c - '0')));
+    } // for
+    return mask;
+} // parse_counts()
+
+} // namespace GameOfLife
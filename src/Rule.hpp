@@ -0,0 +1,90 @@
+/*
+ * Rule.hpp
+ * A life-like rule in B/S notation, compiled into lookup tables for stepping
+ * cells one at a time and into count terms for stepping packed words.
+ */
+
+#ifndef Rule_hpp
+#define Rule_hpp
+
+#include <cstdint>
+#include <stdio.h>
+#include <string>
+
+namespace GameOfLife {
+
+class Rule {
+public:
+    // what happens to a cell with a given state and number of neighbors
+    enum Outcome : unsigned char { DIES, LIVES, CHANCE };
+
+    // a number of neighbors after which a cell is alive, for each state
+    struct Term {
+        unsigned int neighbors;
+        std::uint64_t if_dead;  // all ones if dead cells are born
+        std::uint64_t if_alive; // all ones if living cells survive
+    };
+
+    // parse a rule such as "B3/S23", optionally followed by births that only
+    // happen by chance such as "/P2=0.1,6=0.05"; throws std::invalid_argument
+    // if the rule is malformed
+    explicit Rule(const std::string &notation);
+
+    // return whether notation is a rule that can be parsed
+    static bool is_valid(const std::string &notation);
+
+    // what happens to a cell that is alive or not with neighbors neighbors
+    Outcome outcome(bool alive, int neighbors) const {
+        return table[alive][neighbors];
+    }
+    // the chance a dead cell with neighbors neighbors is born, for CHANCE
+    double birth_chance(int neighbors) const {
+        return chances[neighbors];
+    }
+
+    // return whether no birth depends on chance
+    bool is_deterministic() const {
+        return chance_mask == 0;
+    }
+    // return whether dead cells with no neighbors can be born
+    bool births_without_neighbors() const {
+        return (birth_mask | chance_mask) & 1;
+    }
+    // the neighbor counts with chance births, bit n for n neighbors
+    std::uint16_t get_chance_mask() const {
+        return chance_mask;
+    }
+
+    // the terms for neighbor counts after which any cell is alive
+    const Term *terms_begin() const {
+        return terms;
+    }
+    const Term *terms_end() const {
+        return terms + term_count;
+    }
+
+    // the rule in canonical notation
+    const std::string &get_notation() const {
+        return notation;
+    }
+
+    static constexpr int MAX_NEIGHBORS = 8;
+
+private:
+    // read a list of neighbor counts such as "23" into a mask
+    static std::uint16_t parse_counts(const std::string &counts);
+
+    std::uint16_t birth_mask;
+    std::uint16_t survival_mask;
+    std::uint16_t chance_mask;
+    double chances[MAX_NEIGHBORS + 1];
+
+    Outcome table[2][MAX_NEIGHBORS + 1];
+    Term terms[MAX_NEIGHBORS + 1];
+    unsigned int term_count;
+
+    std::string notation;
+};
+
+} // namespace GameOfLife
+#endif /* Rule_hpp */
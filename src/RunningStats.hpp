@@ -0,0 +1,74 @@
+/*
+ * RunningStats.hpp
+ * The count, mean and variance of a stream of values, kept in one pass with
+ * Welford's method and mergeable with the statistics of another stream.
+ */
+
+#ifndef RunningStats_hpp
+#define RunningStats_hpp
+
+#include <cstdint>
+#include <stdio.h>
+
+namespace GameOfLife {
+
+class RunningStats {
+public:
+    RunningStats() : count(0), mean(0), squares(0) {}
+
+    // add a value to the stream
+    void add(double value) {
+        ++count;
+        double delta = value - mean;
+        mean += delta / static_cast<double>(count);
+        squares += delta * (value - mean);
+    }
+    // add the same value several times
+    void add(double value, std::uint64_t times) {
+        RunningStats same;
+        same.count = times;
+        same.mean = value;
+        merge(same);
+    }
+    // add every value of another stream, as if they had been added one by
+    // one; merging in a fixed order gives the same result every time
+    void merge(const RunningStats &other) {
+        if (other.count == 0) {
+            return;
+        } else if (count == 0) {
+            *this = other;
+            return;
+        } // if
+        double total = static_cast<double>(count + other.count);
+        double delta = other.mean - mean;
+        mean += delta * static_cast<double>(other.count) / total;
+        squares += other.squares + delta * delta *
+                                           static_cast<double>(count) *
+                                           static_cast<double>(other.count) /
+                                           total;
+        count += other.count;
+    }
+
+    std::uint64_t get_count() const {
+        return count;
+    }
+    double get_mean() const {
+        return mean;
+    }
+    double get_sum() const {
+        return mean * static_cast<double>(count);
+    }
+    // the population variance, or zero for an empty stream
+    double get_variance() const {
+        return count == 0 ? 0 : squares / static_cast<double>(count);
+    }
+
+private:
+    std::uint64_t count;
+    double mean;
+    // sum of squared differences from the mean
+    double squares;
+};
+
+} // namespace GameOfLife
+#endif /* RunningStats_hpp */
@@ -0,0 +1,179 @@
+/*
+ * Simulation.hpp
+ * Steps a model on a thread of its own, so a slow generation never holds up
+ * the window and the window's frame rate never limits the generations. The
+ * window sends it commands through a lock-free queue, which it runs between
+ * generations, and it copies the latest board into a frame for the window
+ * through a lock-free triple buffer once the window has taken the last one,
+ * so a board is copied at most once per displayed frame. It steps a
+ * generation at a time after a delay, or in batches that fit a budget of
+ * each frame, whose boards are only published once a batch is done.
+ */
+
+#ifndef Simulation_hpp
+#define Simulation_hpp
+
+#include "LockFreeQueue.hpp"
+#include "TripleBuffer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <stdio.h>
+#include <thread>
+#include <utility>
+
+namespace GameOfLife {
+
+template <typename Frame>
+class Simulation {
+public:
+    // something to do to the model on the simulation's thread
+    typedef std::function<void()> Command;
+
+    // construct a paused simulation that advances the model a generation
+    // with step and copies its latest board into a frame with publish;
+    // neither is called until start()
+    Simulation(std::function<void()> step,
+               std::function<void(Frame &)> publish, const Frame &blank)
+            : step(std::move(step)), publish(std::move(publish)),
+              frames(blank), commands(), stopping(false), thread(),
+              paused(true), changed(false), batching(false), delay(0),
+              budget(0) {}
+    ~Simulation() {
+        stop();
+    }
+    Simulation(const Simulation &) = delete;
+    Simulation &operator=(const Simulation &) = delete;
+
+    // publish the first frame and start stepping on a thread of its own;
+    // the model mustn't be touched from any other thread until stop()
+    void start() {
+        publish(frames.back());
+        frames.publish();
+        thread = std::thread([this]() { run(); });
+    }
+    // stop stepping once the current generation is done
+    void stop() {
+        if (thread.joinable()) {
+            stopping.store(true, std::memory_order_release);
+            thread.join();
+        } // if
+    }
+
+    // run command on the simulation's thread before its next generation,
+    // and publish the board again afterwards; returns false if too many
+    // commands are already waiting
+    bool send(Command command) {
+        return commands.push(std::move(command));
+    }
+    // stop or resume stepping
+    bool set_paused(bool paused_) {
+        return send([this, paused_]() {
+            paused = paused_;
+            batching = false;
+        });
+    }
+    // step a single generation
+    bool step_once() {
+        return send([this]() { step(); });
+    }
+    // start a generation at most once every given number of seconds
+    bool set_delay(double seconds) {
+        return send([this, seconds]() {
+            delay = to_duration(seconds);
+            budget = Clock::duration::zero();
+        });
+    }
+    // start a batch of generations once every period seconds, stepping for
+    // up to budget seconds of it and publishing only the batch's last
+    // generation; a budget longer than the period steps without a break
+    bool set_budget(double budget_seconds, double period_seconds) {
+        return send([this, budget_seconds, period_seconds]() {
+            delay = to_duration(period_seconds);
+            budget = std::min(to_duration(budget_seconds), delay);
+        });
+    }
+
+    // make the latest frame published the current one, returning false if
+    // there's none newer
+    bool take_frame() {
+        return frames.take();
+    }
+    // the frame last taken, valid until the next one is
+    const Frame &get_frame() const {
+        return frames.front();
+    }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    // a number of seconds as a duration of the clock
+    static Clock::duration to_duration(double seconds) {
+        return std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>(seconds));
+    }
+
+    // step, run commands and publish frames until stopped
+    void run() {
+        Clock::time_point next_batch = Clock::now();
+        Clock::time_point batch_end = next_batch;
+        while (!stopping.load(std::memory_order_acquire)) {
+            bool busy = false;
+            Command command;
+            while (commands.pop(command)) {
+                command();
+                changed = busy = true;
+            } // while
+            if (!paused && !batching) {
+                Clock::time_point now = Clock::now();
+                if (now >= next_batch) {
+                    batching = true;
+                    batch_end = now + budget;
+                    next_batch = now + delay;
+                } // if
+            } // if
+            // a batch without a budget is a single generation
+            if (!paused && batching) {
+                step();
+                batching = Clock::now() < batch_end;
+                changed = busy = true;
+            } // if
+            // a board the window hasn't asked for yet isn't copied, and
+            // neither is one in the middle of a batch; the newest one is
+            // once the window has asked for it
+            if (changed && !batching && frames.is_taken()) {
+                publish(frames.back());
+                frames.publish();
+                changed = false;
+            } // if
+            if (!busy) {
+                std::this_thread::sleep_for(IDLE);
+            } // if
+        } // while
+    } // run()
+
+    // how long to wait for something to do while paused or between
+    // batches
+    static constexpr std::chrono::milliseconds IDLE{1};
+
+    std::function<void()> step;
+    std::function<void(Frame &)> publish;
+    TripleBuffer<Frame> frames;
+    LockFreeQueue<Command, 256> commands;
+    std::atomic<bool> stopping;
+    std::thread thread;
+    // only touched on the simulation's thread once it has started
+    bool paused;
+    // whether the board changed since it was last published
+    bool changed;
+    // whether a batch of generations is under way
+    bool batching;
+    // the time from the start of one batch to the next, and how much of it
+    // to spend stepping
+    Clock::duration delay;
+    Clock::duration budget;
+};
+
+} // namespace GameOfLife
+#endif /* Simulation_hpp */
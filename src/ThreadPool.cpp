@@ -0,0 +1,91 @@
+/*
+ * ThreadPool.cpp
+ * A fixed set of worker threads for running the independent pieces of a
+ * generation in parallel.
+ */
+
+#include "ThreadPool.hpp"
+#include <algorithm>
+
+namespace GameOfLife {
+
+// start the workers; zero threads means one per hardware thread
+ThreadPool::ThreadPool(unsigned int threads)
+        : workers(), task(nullptr), count(0), next_task(0), busy(0),
+          batch(0), stopping(false) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    } // if
+    for (unsigned int i = 1; i < threads; ++i) {
+        workers.emplace_back(&ThreadPool::work, this);
+    } // for
+} // ThreadPool()
+
+// stop and join the workers
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    batch_ready.notify_all();
+    for (std::thread &worker : workers) {
+        worker.join();
+    } // for
+} // ~ThreadPool()
+
+// run task(i) for every i in [0, count) across the threads, returning once
+// all of them are done; the calling thread helps out
+void ThreadPool::run(unsigned int count_,
+                     const std::function<void(unsigned int)> &task_) {
+    if (workers.empty() || count_ <= 1) {
+        for (unsigned int i = 0; i < count_; ++i) {
+            task_(i);
+        } // for
+        return;
+    } // if
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        task = &task_;
+        count = count_;
+        next_task = 0;
+        busy = static_cast<unsigned int>(workers.size());
+        ++batch;
+    }
+    batch_ready.notify_all();
+    run_tasks();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    batch_done.wait(lock, [this] { return busy == 0; });
+    task = nullptr;
+} // run()
+
+// run tasks from the current batch until none are left
+void ThreadPool::run_tasks() {
+    for (unsigned int i = next_task++; i < count; i = next_task++) {
+        (*task)(i);
+    } // for
+} // run_tasks()
+
+// wait for batches of tasks and help run them until stopped
+void ThreadPool::work() {
+    std::uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            batch_ready.wait(lock, [&] { return stopping || batch != seen; });
+            if (stopping) {
+                return;
+            } // if
+            seen = batch;
+        }
+        run_tasks();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --busy;
+        }
+        batch_done.notify_one();
+    } // while
+} // work()
+
+} // namespace GameOfLife
@@ -0,0 +1,61 @@
+/*
+ * ThreadPool.hpp
+ * A fixed set of worker threads for running the independent pieces of a
+ * generation in parallel.
+ */
+
+#ifndef ThreadPool_hpp
+#define ThreadPool_hpp
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+namespace GameOfLife {
+
+class ThreadPool {
+public:
+    // start the workers; zero threads means one per hardware thread
+    explicit ThreadPool(unsigned int threads);
+    // stop and join the workers
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // run task(i) for every i in [0, count) across the threads, returning
+    // once all of them are done; the calling thread helps out
+    void run(unsigned int count, const std::function<void(unsigned int)> &task);
+
+    // the number of threads tasks run on, including the caller
+    unsigned int size() const {
+        return static_cast<unsigned int>(workers.size()) + 1;
+    }
+
+private:
+    // wait for batches of tasks and help run them until stopped
+    void work();
+    // run tasks from the current batch until none are left
+    void run_tasks();
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable batch_ready;
+    std::condition_variable batch_done;
+
+    const std::function<void(unsigned int)> *task;
+    unsigned int count;
+    std::atomic<unsigned int> next_task;
+    // workers still running tasks from the current batch
+    unsigned int busy;
+    std::uint64_t batch;
+    bool stopping;
+};
+
+} // namespace GameOfLife
+#endif /* ThreadPool_hpp */
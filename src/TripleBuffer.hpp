@@ -0,0 +1,71 @@
+/*
+ * TripleBuffer.hpp
+ * Hands the latest of a stream of values from one thread to another without
+ * either waiting on a lock. The writer fills the back buffer and swaps it
+ * with the middle one; the reader swaps the middle buffer with the front
+ * one whenever a new value is there. Neither ever touches the buffer the
+ * other is using.
+ */
+
+#ifndef TripleBuffer_hpp
+#define TripleBuffer_hpp
+
+#include <atomic>
+#include <stdio.h>
+
+namespace GameOfLife {
+
+template <typename T>
+class TripleBuffer {
+public:
+    // construct a buffer whose every value starts as initial
+    explicit TripleBuffer(const T &initial)
+            : buffers{initial, initial, initial}, middle(1), back_index(0),
+              front_index(2) {}
+
+    // the value the writer fills in before publishing it
+    T &back() {
+        return buffers[back_index];
+    }
+    // make the back value the latest, replacing any the reader hasn't taken
+    void publish() {
+        back_index = middle.exchange(back_index | FRESH,
+                                     std::memory_order_acq_rel) &
+                     INDEX;
+    }
+    // whether the reader has taken the latest value published; called by
+    // the writer
+    bool is_taken() const {
+        return (middle.load(std::memory_order_acquire) & FRESH) == 0;
+    }
+
+    // make the latest value published the front one, returning false if
+    // there's none newer than the front one already
+    bool take() {
+        if ((middle.load(std::memory_order_relaxed) & FRESH) == 0) {
+            return false;
+        } // if
+        front_index = middle.exchange(front_index, std::memory_order_acq_rel) &
+                      INDEX;
+        return true;
+    }
+    // the value the reader last took, valid until it next takes one
+    const T &front() const {
+        return buffers[front_index];
+    }
+
+private:
+    // the middle buffer's index shares a word with whether it holds a value
+    // the reader hasn't taken yet
+    static constexpr unsigned int INDEX = 3;
+    static constexpr unsigned int FRESH = 4;
+
+    T buffers[3];
+    std::atomic<unsigned int> middle;
+    // only touched by the writer and the reader respectively
+    unsigned int back_index;
+    unsigned int front_index;
+};
+
+} // namespace GameOfLife
+#endif /* TripleBuffer_hpp */
@@ -4,37 +4,250 @@
  */
 
 #include "View.hpp"
-#include <cassert>
+#include <algorithm>
+#include <cmath>
 namespace GameOfLife {
 
 // cosntruct a view and set up the window
-View::View(unsigned int width, unsigned int height, sf::RenderWindow &window,
-           std::string output_file_name_)
-        : color_map(), texture(), sprite(), window(window),
-          output_file_name(""), extension_num(0) {
-    color_map.resize(width * height * RGBA_BLOCK, 255);
-
-    // set xScale and yScale for texture vs window
-    sf::Vector2u windowSize = window.getSize();
-    xScale = static_cast<float>(windowSize.x) / width;
-    yScale = static_cast<float>(windowSize.y) / height;
+View::View(unsigned int width, unsigned int height, sf::RenderWindow &window)
+        : width(width), height(height), origin_x(0), origin_y(0),
+          factor_x(1), factor_y(1), texture_cols(0), texture_rows(0),
+          box_edges(), pixels(), byte_masks(256 * CELLS_PER_RUN), texture(),
+          sprite(), xScale(1), yScale(1), window(window), generations(0),
+          model_was_updated(false), turbo(0), timers(nullptr),
+          window_width(std::max(window.getSize().x, 1u)),
+          window_height(std::max(window.getSize().y, 1u)),
+          // the graphics card limits the texture's size, which needs room
+          // for a run on either side of the pixels in view
+          resolution_x(std::min(window_width, sf::Texture::getMaximumSize() -
+                                                      2 * CELLS_PER_RUN)),
+          resolution_y(std::min(window_height, sf::Texture::getMaximumSize() -
+                                                       2 * CELLS_PER_RUN)),
+          texture_width(std::min(width, resolution_x + 2 * CELLS_PER_RUN)),
+          texture_height(std::min(height, resolution_y + 2 * CELLS_PER_RUN)),
+          zoom_level(0), center_x(width / 2.0), center_y(height / 2.0),
+          viewport_changed(true), pool(0),
+          tiles_across((texture_width + DIRTY_TILE - 1) / DIRTY_TILE),
+          tiles_down((texture_height + DIRTY_TILE - 1) / DIRTY_TILE),
+          // the texture starts out blank, so every tile is uploaded first
+          dirty_tiles(static_cast<std::size_t>(tiles_across) * tiles_down, 1),
+          upload_buffer() {
+    pixels.assign(static_cast<std::size_t>(texture_width) * texture_height,
+                  to_pixel(0));
+
+    for (unsigned int byte = 0; byte < 256; ++byte) {
+        for (unsigned int bit = 0; bit < CELLS_PER_RUN; ++bit) {
+            byte_masks[byte * CELLS_PER_RUN + bit] =
+                    (byte >> bit) & 1 ? ~std::uint32_t{0} : 0;
+        } // for
+    }     // for
+
+    texture.create(texture_width, texture_height);
+    sprite.setTexture(texture);
+    update_viewport();
+} // View()
+
+// zoom in steps times, or out if steps is negative, keeping the cell under
+// window pixel (x, y) where it is
+void View::zoom(int steps, int x, int y) {
+    double scale = std::ldexp(1.0, -static_cast<int>(zoom_level));
+    double across = std::min(std::max(static_cast<double>(x) / window_width,
+                                      0.0),
+                             1.0);
+    double down = std::min(
+            std::max(static_cast<double>(y) / window_height, 0.0), 1.0);
+    double cell_x = center_x + (across - 0.5) * width * scale;
+    double cell_y = center_y + (down - 0.5) * height * scale;
+
+    int max_level = 0;
+    while ((std::min(width, height) >> (max_level + 1)) >= MIN_VISIBLE) {
+        ++max_level;
+    } // while
+    zoom_level = static_cast<unsigned int>(std::min(
+            std::max(static_cast<int>(zoom_level) + steps, 0), max_level));
+
+    scale = std::ldexp(1.0, -static_cast<int>(zoom_level));
+    center_x = cell_x - (across - 0.5) * width * scale;
+    center_y = cell_y - (down - 0.5) * height * scale;
+    update_viewport();
+} // zoom()
+
+// move the board the given number of window pixels right and down
+void View::pan(int dx, int dy) {
+    double scale = std::ldexp(1.0, -static_cast<int>(zoom_level));
+    center_x -= dx * scale * width / window_width;
+    center_y -= dy * scale * height / window_height;
+    update_viewport();
+} // pan()
+
+// show the whole board again
+void View::show_all() {
+    zoom_level = 0;
+    center_x = width / 2.0;
+    center_y = height / 2.0;
+    update_viewport();
+} // show_all()
+
+// the board cell under window pixel (x, y), or (-1, -1) if the pixel is
+// outside the window
+sf::Vector2i View::cell_at(int x, int y) const {
+    if (x < 0 || y < 0 || static_cast<unsigned int>(x) >= window_width ||
+        static_cast<unsigned int>(y) >= window_height) {
+        return sf::Vector2i(-1, -1);
+    } // if
+    // the cell under the middle of the pixel
+    double scale = std::ldexp(1.0, -static_cast<int>(zoom_level));
+    double across = (x + 0.5) / window_width;
+    double down = (y + 0.5) / window_height;
+    double cell_x = center_x + (across - 0.5) * width * scale;
+    double cell_y = center_y + (down - 0.5) * height * scale;
+    // rounding can put a pixel on the window's edge just off the board
+    return sf::Vector2i(
+            static_cast<int>(std::min(std::max(cell_x, 0.0),
+                                      static_cast<double>(width - 1))),
+            static_cast<int>(std::min(std::max(cell_y, 0.0),
+                                      static_cast<double>(height - 1))));
+} // cell_at()
+
+// how brightly to show a box of area cells, count of which are alive, out
+// of 255
+unsigned int View::coverage(std::uint64_t count, std::uint64_t area) {
+    if (area == 0) {
+        return 0;
+    } // if
+    return static_cast<unsigned int>(
+            std::lround(255.0 * std::sqrt(static_cast<double>(count) /
+                                          static_cast<double>(area))));
+} // coverage()
+
+// work out which cells the texture shows, and where the sprite goes, from
+// the zoom level and the center of the view
+void View::update_viewport() {
+    double scale = std::ldexp(1.0, -static_cast<int>(zoom_level));
+    double visible_x = width * scale;
+    double visible_y = height * scale;
+    // the board always fills the window
+    center_x = std::min(std::max(center_x, visible_x / 2),
+                        width - visible_x / 2);
+    center_y = std::min(std::max(center_y, visible_y / 2),
+                        height - visible_y / 2);
+    double left = center_x - visible_x / 2;
+    double top = center_y - visible_y / 2;
+    double right = std::min(left + visible_x, static_cast<double>(width));
+    double bottom = std::min(top + visible_y, static_cast<double>(height));
+
+    // as few cells per pixel as fit the cells in view into the texture. A
+    // texture of single cells starts on a whole run, so rows are read a
+    // byte at a time; one of boxes starts on a whole box, so the boxes
+    // don't shift under the cells as the view pans
+    factor_x = static_cast<unsigned int>(std::ceil(visible_x / resolution_x));
+    factor_y = static_cast<unsigned int>(std::ceil(visible_y / resolution_y));
+    unsigned int align_x = factor_x == 1 ? CELLS_PER_RUN : factor_x;
+    origin_x = static_cast<unsigned int>(left) / align_x * align_x;
+    origin_y = static_cast<unsigned int>(top) / factor_y * factor_y;
+    texture_cols = std::min(texture_width,
+                            static_cast<unsigned int>(
+                                    std::ceil((right - origin_x) / factor_x)));
+    texture_rows = std::min(texture_height,
+                            static_cast<unsigned int>(
+                                    std::ceil((bottom - origin_y) / factor_y)));
+    box_edges.resize(texture_cols + 1);
+    for (unsigned int col = 0; col <= texture_cols; ++col) {
+        box_edges[col] = std::min(box_left(col), width);
+    } // for
+
+    // the sprite stretches the pixels in view over the window, shifted by
+    // however much of the first run or box is out of view
+    xScale = static_cast<float>(window_width * factor_x / visible_x);
+    yScale = static_cast<float>(window_height * factor_y / visible_y);
+    sprite.setTextureRect(sf::IntRect(0, 0, static_cast<int>(texture_cols),
+                                      static_cast<int>(texture_rows)));
     sprite.setScale(xScale, yScale);
+    sprite.setPosition(
+            static_cast<float>((origin_x - left) / factor_x * xScale),
+            static_cast<float>((origin_y - top) / factor_y * yScale));
+    viewport_changed = true;
+} // update_viewport()
 
-    // set all RGBA values to black and opaque
-    for (unsigned int i = 0; i < width * height * RGBA_BLOCK; i += RGBA_BLOCK) {
-        color_map[i + A_POS] = FULL_ALPHA;
+// copy the tiles of pixels that changed into the texture once they've been
+// drawn
+void View::upload_texture() {
+    // rows of tiles that all changed are uploaded together straight from
+    // the pixels, since they're contiguous
+    unsigned int band_begin = 0, band_rows = 0;
+    for (unsigned int tile_row = 0; tile_row < tiles_down; ++tile_row) {
+        unsigned char *dirty = &dirty_tiles[tile_row * tiles_across];
+        unsigned char *dirty_end = dirty + tiles_across;
+        bool whole = std::find(dirty, dirty_end, 0) == dirty_end;
+        if (whole) {
+            if (band_rows == 0) {
+                band_begin = tile_row;
+            } // if
+            ++band_rows;
+        } else {
+            // each run of neighboring tiles that changed is one rectangle
+            unsigned int top = tile_row * DIRTY_TILE;
+            unsigned int rows = std::min(DIRTY_TILE, texture_height - top);
+            for (unsigned int tile = 0; tile < tiles_across;) {
+                if (!dirty[tile]) {
+                    ++tile;
+                    continue;
+                } // if
+                unsigned int left = tile * DIRTY_TILE;
+                while (tile < tiles_across && dirty[tile]) {
+                    ++tile;
+                } // while
+                upload_rect(left, top,
+                            std::min(tile * DIRTY_TILE, texture_width) - left,
+                            rows);
+            } // for
+        } // if/else
+        // a band ends at the first row of tiles that didn't all change
+        if (band_rows > 0 && (!whole || tile_row + 1 == tiles_down)) {
+            unsigned int top = band_begin * DIRTY_TILE;
+            unsigned int bottom = std::min(
+                    (band_begin + band_rows) * DIRTY_TILE, texture_height);
+            upload_rect(0, top, texture_width, bottom - top);
+            band_rows = 0;
+        } // if
+        std::fill(dirty, dirty_end, 0);
     } // for
+    model_was_updated = viewport_changed = false;
+} // upload_texture()
 
-    texture.create(width, height);
-    sprite.setTexture(texture);
-    sprite.setPosition(0, 0);
+// copy a rectangle of pixels into the texture
+void View::upload_rect(unsigned int left, unsigned int top, unsigned int cols,
+                       unsigned int rows) {
+    const std::uint32_t *source =
+            &pixels[static_cast<std::size_t>(top) * texture_width + left];
+    if (cols < texture_width) {
+        upload_buffer.resize(static_cast<std::size_t>(cols) * rows);
+        for (unsigned int row = 0; row < rows; ++row) {
+            std::memcpy(&upload_buffer[static_cast<std::size_t>(row) * cols],
+                        source + static_cast<std::size_t>(row) * texture_width,
+                        cols * sizeof(std::uint32_t));
+        } // for
+        source = upload_buffer.data();
+    } // if
+    texture.update(reinterpret_cast<const sf::Uint8 *>(source), cols, rows,
+                   left, top);
+} // upload_rect()
 
-    output_file_name += output_file_name_;
-} // View()
+// the turbo level to add to the title bar, if there's one
+std::string View::turbo_title() const {
+    if (turbo == 0) {
+        return std::string();
+    } // if
+    return ", turbo: " + std::to_string(turbo);
+} // turbo_title()
 
-// close the output file
-View::~View() {
-    output_file.close();
-}
+// the timers' summary to add to the title bar, if they're on
+std::string View::timing_title() const {
+    if (timers == nullptr || !timers->is_enabled() ||
+        timers->get_summary().empty()) {
+        return std::string();
+    } // if
+    return ", " + timers->get_summary();
+} // timing_title()
 
 } // namespace GameOfLife
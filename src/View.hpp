@@ -1,37 +1,214 @@
 /*
  * View.hpp
- * A general class representing a view for any game mode
+ * A general class representing a view for any game mode. The texture is
+ * only as large as the window: each of its pixels shows a single cell of
+ * the part of the board in view, or, once more cells are in view than the
+ * window has pixels, a box of them filtered down on the CPU.
  */
 
 #ifndef View_hpp
 #define View_hpp
 
+#include "BitGrid.hpp"
+#include "BoxCounter.hpp"
+#include "Canvas.hpp"
+#include "PhaseTimers.hpp"
+#include "ThreadPool.hpp"
 #include <SFML/Graphics.hpp>
-#include <fstream>
-#include <iostream>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <stdio.h>
+#include <string>
+#include <vector>
 namespace GameOfLife {
 
-class View {
+class View : public Canvas {
 public:
     // cosntruct a view and set up the window
-    View(unsigned int width, unsigned int height, sf::RenderWindow &window,
-         std::string output_file_name);
-    // close the output files
-    ~View();
+    View(unsigned int width, unsigned int height, sf::RenderWindow &window);
 
     // display the grid
     virtual void display() = 0;
 
+    // set the generation shown in the title bar once the model has
+    // finished stepping, so its board is drawn again on the next frame
+    void set_generations(std::uint64_t generations_) override {
+        generations = generations_;
+        model_was_updated = true;
+    }
+    // time drawing with timers and show their summary in the title bar, or
+    // neither if timers is null
+    void set_timers(PhaseTimers *timers_) {
+        timers = timers_;
+    }
+    // set the turbo level shown in the title bar
+    void set_turbo(unsigned int turbo_) {
+        turbo = turbo_;
+    }
+
+    // zoom in steps times, or out if steps is negative, keeping the cell
+    // under window pixel (x, y) where it is; each step halves or doubles the
+    // cells in view across and down
+    void zoom(int steps, int x, int y);
+    // zoom in or out about the middle of the window
+    void zoom(int steps) {
+        zoom(steps, static_cast<int>(window_width / 2),
+             static_cast<int>(window_height / 2));
+    }
+    // move the board the given number of window pixels right and down
+    void pan(int dx, int dy);
+    // show the whole board again
+    void show_all();
+    // the board cell under window pixel (x, y), or (-1, -1) if the pixel is
+    // outside the window
+    sf::Vector2i cell_at(int x, int y) const;
+
 protected:
-    static constexpr unsigned int R_POS = 0;
-    static constexpr unsigned int G_POS = 1;
-    static constexpr unsigned int B_POS = 2;
-    static constexpr unsigned int A_POS = 3;
+    // whether the model has stepped or the view moved since the board was
+    // last drawn
+    bool needs_render() const {
+        return model_was_updated || viewport_changed;
+    }
+    // whether each pixel of the texture is a single cell rather than a box
+    // of them
+    bool is_full_detail() const {
+        return factor_x == 1 && factor_y == 1;
+    }
+    // copy the tiles of pixels that changed into the texture once they've
+    // been drawn
+    void upload_texture();
+    // the turbo level to add to the title bar, if there's one
+    std::string turbo_title() const;
+    // the timers' summary to add to the title bar, if they're on
+    std::string timing_title() const;
+
+    // a color packed as 0xRRGGBB as an opaque pixel
+    static std::uint32_t to_pixel(unsigned int color) {
+        const std::uint8_t rgba[RGBA_BLOCK] = {
+                static_cast<std::uint8_t>(color >> 16),
+                static_cast<std::uint8_t>(color >> 8),
+                static_cast<std::uint8_t>(color), FULL_ALPHA};
+        std::uint32_t pixel;
+        std::memcpy(&pixel, rgba, sizeof(pixel));
+        return pixel;
+    }
+    // a color packed as 0xRRGGBB dimmed to brightness out of 255
+    static unsigned int dim(unsigned int color, unsigned int brightness) {
+        unsigned int dimmed = 0;
+        for (unsigned int shift = 0; shift < 24; shift += 8) {
+            dimmed |= ((color >> shift & 0xFF) * brightness / 255) << shift;
+        } // for
+        return dimmed;
+    }
+    // how brightly to show a box of area cells, count of which are alive,
+    // out of 255; the square root keeps sparse patterns from fading out
+    static unsigned int coverage(std::uint64_t count, std::uint64_t area);
+
+    // the masks of the eight cells of a packed row starting at col, a
+    // multiple of eight: all ones for a living cell, zero for a dead one
+    const std::uint32_t *cell_masks(const std::uint64_t *words,
+                                    unsigned int col) const {
+        std::uint64_t word = words[col / BitGrid::WORD_BITS];
+        std::uint64_t byte = (word >> (col % BitGrid::WORD_BITS)) & 0xFF;
+        return &byte_masks[byte * CELLS_PER_RUN];
+    }
+    // the board columns [box_left(col), box_right(col)) and rows
+    // [box_top(row), box_bottom(row)) that pixel (row, col) of the texture
+    // shows; boxes past the board's edge are cut short
+    unsigned int box_left(unsigned int col) const {
+        return origin_x + col * factor_x;
+    }
+    unsigned int box_right(unsigned int col) const {
+        unsigned int left = box_left(col);
+        return left < width ? std::min(left + factor_x, width) : left;
+    }
+    unsigned int box_top(unsigned int row) const {
+        return origin_y + row * factor_y;
+    }
+    unsigned int box_bottom(unsigned int row) const {
+        unsigned int top = box_top(row);
+        return top < height ? std::min(top + factor_y, height) : top;
+    }
+    // the number of cells pixel (row, col) of the texture shows
+    std::uint64_t box_area(unsigned int row, unsigned int col) const {
+        return static_cast<std::uint64_t>(box_bottom(row) - box_top(row)) *
+               (box_right(col) - box_left(col));
+    }
+    // the number of texture columns in use rounded up to whole runs, which
+    // draw_row() may ask a shade for
+    unsigned int run_cols() const {
+        return (texture_cols + CELLS_PER_RUN - 1) / CELLS_PER_RUN *
+               CELLS_PER_RUN;
+    }
+
+    // draw the texture rows in use in parallel, draw(begin, end) drawing
+    // rows [begin, end) with draw_row(); each call gets whole rows of
+    // tiles, so no two threads mark the same tile
+    template <typename Draw>
+    void draw_rows(Draw draw) {
+        unsigned int bands = (texture_rows + DIRTY_TILE - 1) / DIRTY_TILE;
+        pool.run(bands, [&](unsigned int band) {
+            draw(band * DIRTY_TILE,
+                 std::min((band + 1) * DIRTY_TILE, texture_rows));
+        });
+    }
+    // draw a row of the texture eight pixels at a time, shade(col, run)
+    // writing the pixels starting at col into run; every run is the same
+    // length, so the compiler can turn shade's loop into vector
+    // instructions. Runs that differ from the pixels already drawn mark
+    // their tile to be uploaded
+    template <typename Shade>
+    void draw_row(unsigned int row, Shade shade) {
+        std::uint32_t *out =
+                &pixels[static_cast<std::size_t>(row) * texture_width];
+        unsigned char *dirty = &dirty_tiles[(row / DIRTY_TILE) * tiles_across];
+        std::uint32_t run[CELLS_PER_RUN];
+        unsigned int col = 0;
+        for (; col + CELLS_PER_RUN <= texture_cols; col += CELLS_PER_RUN) {
+            shade(col, run);
+            std::uint32_t changed = 0;
+            for (unsigned int cell = 0; cell < CELLS_PER_RUN; ++cell) {
+                changed |= out[col + cell] ^ run[cell];
+            } // for
+            if (changed != 0) {
+                std::memcpy(out + col, run, sizeof(run));
+                dirty[col / DIRTY_TILE] = 1;
+            } // if
+        } // for
+        // the last pixels of a row that isn't a whole number of runs
+        if (col < texture_cols) {
+            shade(col, run);
+            std::size_t bytes = (texture_cols - col) * sizeof(run[0]);
+            if (std::memcmp(out + col, run, bytes) != 0) {
+                std::memcpy(out + col, run, bytes);
+                dirty[col / DIRTY_TILE] = 1;
+            } // if
+        } // if
+    }
+
     static constexpr unsigned int RGBA_BLOCK = 4;
-    static constexpr std::uint_fast8_t MAX_RGB = 255;
-    static constexpr std::uint_fast8_t FULL_ALPHA = 255;
-    std::vector<std::uint_fast8_t> color_map;
+    static constexpr std::uint8_t FULL_ALPHA = 255;
+    static constexpr unsigned int CELLS_PER_RUN = 8;
+    // the width and height of the tiles that are uploaded if any of their
+    // pixels changed; a multiple of CELLS_PER_RUN
+    static constexpr unsigned int DIRTY_TILE = 64;
+    // the board's size in cells
+    unsigned int width, height;
+    // the board cell at the texture's top left corner, how many cells
+    // across and down each texture pixel shows, and how many columns and
+    // rows of the texture are in use
+    unsigned int origin_x, origin_y;
+    unsigned int factor_x, factor_y;
+    unsigned int texture_cols, texture_rows;
+    // the board column where each box of a texture row starts, followed by
+    // where the last one ends
+    std::vector<unsigned int> box_edges;
+    // one pixel per texture pixel, row by row, its bytes red, green, blue
+    // and alpha in memory as the texture takes them
+    std::vector<std::uint32_t> pixels;
+    // the masks of the eight cells packed in each value of a byte
+    std::vector<std::uint32_t> byte_masks;
 
     sf::Texture texture;
     sf::Sprite sprite;
@@ -40,10 +217,39 @@ protected:
     sf::RenderWindow &window;
     std::uint64_t generations;
     bool model_was_updated;
+    unsigned int turbo;
+    PhaseTimers *timers;
+
+private:
+    // work out which cells the texture shows, and where the sprite goes,
+    // from the zoom level and the center of the view
+    void update_viewport();
+    // copy a rectangle of pixels into the texture
+    void upload_rect(unsigned int left, unsigned int top, unsigned int cols,
+                     unsigned int rows);
+
+    // zooming stops once fewer cells than this are in view across or down
+    static constexpr unsigned int MIN_VISIBLE = 8;
+    // the window's size in pixels, and the most texture pixels across and
+    // down to show it with
+    unsigned int window_width, window_height;
+    unsigned int resolution_x, resolution_y;
+    // the allocated size of the texture, which is at least as large as any
+    // part of it in use
+    unsigned int texture_width, texture_height;
+    // each zoom level halves the cells in view across and down; the view
+    // is centered on the board cell (center_x, center_y)
+    unsigned int zoom_level;
+    double center_x, center_y;
+    bool viewport_changed;
+    // downsamples boards larger than the window across the cores
+    ThreadPool pool;
 
-    std::string output_file_name;
-    std::ofstream output_file;
-    int extension_num;
+    // whether each tile, row by row, changed since it was last uploaded
+    unsigned int tiles_across, tiles_down;
+    std::vector<unsigned char> dirty_tiles;
+    // the pixels of a rectangle narrower than the texture, packed for upload
+    std::vector<std::uint32_t> upload_buffer;
 };
 
 } // namespace GameOfLife
@@ -4,104 +4,106 @@
  */
 
 #include "ViewAllele.hpp"
+#include <vector>
 #include <iomanip>
 #include <sstream>
 
 namespace GameOfLife {
 
 ViewAllele::ViewAllele(unsigned int width, unsigned int height,
-                       sf::RenderWindow &window, std::string output_file_name)
-        : View(width, height, window, output_file_name), is_recording(false) {
-    to_write.reserve(WRITE_DELTA);
-} // ViewAllele()
+                       sf::RenderWindow &window)
+        : View(width, height, window), is_recording(false) {} // ViewAllele()
 
-// write any remaiing data to a file
-ViewAllele::~ViewAllele() {
-    if (output_file.is_open()) {
-        output_file << to_write;
-        to_write.clear();
-        output_file.close();
-    }
-} // ~ViewAllele()
-
-// update the colors of a single cell
-void ViewAllele::update(unsigned int position, int color,
-                        std::uint64_t generations_) {
-    // get RGB data from hex value
-    std::uint_fast8_t red = ((color >> 16) & 0xFF);
-    std::uint_fast8_t green = ((color >> 8) & 0xFF);
-    std::uint_fast8_t blue = color & 0xFF;
-
-    // multi position by length of block to get start of pos block
-    position *= RGBA_BLOCK;
-    color_map[position + R_POS] = red;
-    color_map[position + G_POS] = green;
-    color_map[position + B_POS] = blue;
-    color_map[position + A_POS] = FULL_ALPHA;
-
-    generations = generations_;
-    model_was_updated = true;
-} // update()
+// draw the cells of the model's board into the texture if it has stepped
+// or the view has moved since they were last drawn: dominant cells blue,
+// recessive cells yellow and dead cells black
+void ViewAllele::render(const BitGrid &alive, const BitGrid &dominant_1,
+                        const BitGrid &dominant_2) {
+    if (!needs_render()) {
+        return;
+    } // if
+    ScopedPhase phase(timers, PhaseTimers::TEXTURE);
+    const std::uint32_t dead = to_pixel(0x000000);
+    const std::uint32_t to_recessive = dead ^ to_pixel(RECESSIVE);
+    const std::uint32_t to_dominant = to_pixel(RECESSIVE) ^ to_pixel(DOMINANT);
+    draw_rows([&](unsigned int begin, unsigned int end) {
+        // the alleles of dead cells are clear, so only living cells can be
+        // dominant
+        std::vector<std::uint64_t> dominant(alive.get_words_per_row());
+        auto merge_dominant = [&](unsigned int y) {
+            const std::uint64_t *words_1 = dominant_1.row_data(y);
+            const std::uint64_t *words_2 = dominant_2.row_data(y);
+            for (std::size_t word = 0; word < dominant.size(); ++word) {
+                dominant[word] = words_1[word] | words_2[word];
+            } // for
+        };
+        if (is_full_detail()) {
+            for (unsigned int row = begin; row < end; ++row) {
+                const std::uint64_t *living_words =
+                        alive.row_data(origin_y + row);
+                merge_dominant(origin_y + row);
+                draw_row(row, [&](unsigned int col, std::uint32_t *run) {
+                    const std::uint32_t *living =
+                            cell_masks(living_words, origin_x + col);
+                    const std::uint32_t *dominants =
+                            cell_masks(dominant.data(), origin_x + col);
+                    for (unsigned int cell = 0; cell < CELLS_PER_RUN; ++cell) {
+                        run[cell] = dead ^ (living[cell] & to_recessive) ^
+                                    (dominants[cell] & to_dominant);
+                    } // for
+                });
+            } // for
+        } else {
+            // a box of cells is the color of the phenotype most of its living
+            // cells have, as bright as how many of them are alive
+            BoxCounter living_counter(alive.get_words_per_row());
+            BoxCounter dominant_counter(alive.get_words_per_row());
+            std::vector<std::uint32_t> living(run_cols());
+            std::vector<std::uint32_t> dominants(run_cols());
+            for (unsigned int row = begin; row < end; ++row) {
+                std::fill(living.begin(), living.end(), 0);
+                std::fill(dominants.begin(), dominants.end(), 0);
+                for (unsigned int y = box_top(row); y < box_bottom(row); ++y) {
+                    living_counter.add_row(alive.row_data(y));
+                    merge_dominant(y);
+                    dominant_counter.add_row(dominant.data());
+                } // for
+                living_counter.take_counts(box_edges, living.data());
+                dominant_counter.take_counts(box_edges, dominants.data());
+                draw_row(row, [&](unsigned int col, std::uint32_t *run) {
+                    for (unsigned int cell = 0; cell < CELLS_PER_RUN; ++cell) {
+                        unsigned int x = col + cell;
+                        unsigned int color =
+                                2 * dominants[x] >= living[x] ? DOMINANT
+                                                              : RECESSIVE;
+                        unsigned int brightness =
+                                coverage(living[x], box_area(row, x));
+                        run[cell] = to_pixel(dim(color, brightness));
+                    } // for
+                });
+            } // for
+        } // if/else
+    });
+    upload_texture();
+} // render()
 
 // display the grid
 void ViewAllele::display() {
-    if (model_was_updated) {
-        texture.update(&color_map[0]);
-        model_was_updated = false;
-    } // if
+    ScopedPhase phase(timers, PhaseTimers::DRAW);
 
     std::stringstream stream;
     stream << "generations: " << std::to_string(generations)
            << ", recording: " << std::boolalpha << is_recording
-           << ", genotype: " << geno;
+           << ", genotype: " << geno << turbo_title()
+           << timing_title();
     window.setTitle(std::string(stream.str()));
     window.draw(sprite);
 } // display()
 
-// write any recorded data to the output file
-void ViewAllele::write_data(double dominant_freq, double recessive_freq,
-                            double dominant_pheno, double recessive_pheno) {
-    to_write += std::to_string(generations);
-    to_write += ',';
-    to_write += std::to_string(dominant_freq);
-    to_write += ',';
-    to_write += std::to_string(recessive_freq);
-    to_write += ',';
-    to_write += std::to_string(dominant_pheno);
-    to_write += ',';
-    to_write += std::to_string(recessive_pheno);
-    to_write += '\n';
-    size_t temp = to_write.size();
-    if (temp >= WRITE_DELTA) {
-        output_file << to_write;
-        to_write.clear();
-        to_write.reserve(WRITE_DELTA);
-    }
-} // write_date()
-
-// toggle whether we are recording or not, creating a new file if needed
-void ViewAllele::toggle_recording() {
-    if (output_file.is_open()) {
-        output_file << to_write;
-        to_write.clear();
-    }
-    is_recording = !is_recording;
-    if (is_recording) {
-        output_file.close();
-        std::string name = output_file_name;
-        name += '_';
-        name += std::to_string(extension_num);
-        name += ".csv";
-        output_file.open(name, std::fstream::out);
-        if (!output_file.is_open()) {
-            assert(false);
-        }
-        to_write +=
-                "Generation,Dominant Frequency,Recessive Frequency,Dominant "
-                "Pheno. Frequency,Recessive Pheno. Frequency\n";
-        ++extension_num;
-    }
-}
+// show whether the model is recording data
+void ViewAllele::set_recording(bool is_recording_) {
+    is_recording = is_recording_;
+} // set_recording()
 
 // update the title bar
 void ViewAllele::update_title(std::string geno_) {
@@ -109,7 +111,8 @@ void ViewAllele::update_title(std::string geno_) {
     std::stringstream stream;
     stream << "generation: " << std::to_string(generations)
            << ", recording: " << std::boolalpha << is_recording
-           << ", genotype: " << geno_;
+           << ", genotype: " << geno_ << turbo_title()
+           << timing_title();
     window.setTitle(std::string(stream.str()));
 }
 
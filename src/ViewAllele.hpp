@@ -6,6 +6,7 @@
 #ifndef ViewAllele_hpp
 #define ViewAllele_hpp
 
+#include "BitGrid.hpp"
 #include "View.hpp"
 #include <stdio.h>
 
@@ -14,31 +15,30 @@ namespace GameOfLife {
 class ViewAllele : public View {
 public:
     ViewAllele(unsigned int width, unsigned int height,
-               sf::RenderWindow &window, std::string output_file_name);
+               sf::RenderWindow &window);
 
-    // write any remaining data to a file
-    ~ViewAllele();
+    // draw the cells of the model's board into the texture if it has
+    // stepped or the view has moved since they were last drawn: dominant
+    // cells blue, recessive cells yellow and dead cells black
+    void render(const BitGrid &alive, const BitGrid &dominant_1,
+                const BitGrid &dominant_2);
 
-    // update the colors of a single cell
-    void update(unsigned int position, int color, std::uint64_t generations_);
-
-    // write any recorded data to the output file
-    void write_data(double dominant_freq, double recessive_freq,
-                    double dominant_pheno, double recessive_phenos);
     // display the grid
     void display() override;
 
-    // toggle whether we are recording or not, creating a new file if needed
-    void toggle_recording();
+    // show whether the model is recording data
+    void set_recording(bool is_recording_);
 
     // update the title bar
     void update_title(std::string geno);
 
 private:
     std::string geno;
-    std::string to_write;
-    static constexpr unsigned int WRITE_DELTA = 1000;
     bool is_recording;
+
+    // dom/recessive colors
+    static constexpr unsigned int DOMINANT = 0x0000FF;
+    static constexpr unsigned int RECESSIVE = 0xFFFF00;
 };
 
 } // namespace GameOfLife
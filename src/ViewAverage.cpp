@@ -4,111 +4,126 @@
  */
 
 #include "ViewAverage.hpp"
+#include <algorithm>
 #include <iomanip>
 #include <sstream>
+#include <vector>
 
 namespace GameOfLife {
 
 ViewAverage::ViewAverage(unsigned int width, unsigned int height,
-                         sf::RenderWindow &window, std::string output_file_name)
-        : View(width, height, window, output_file_name), ideal_color(0),
-          is_recording(false) {
-    to_write.reserve(WRITE_DELTA);
+                         sf::RenderWindow &window)
+        : View(width, height, window), ideal_color(0), is_recording(false) {
 } // ViewAverage()
 
-// write any remaining data to files
-ViewAverage::~ViewAverage() {
-    if (output_file.is_open()) {
-        output_file << to_write;
-        to_write.clear();
-        output_file.close();
-    }
-} // ~ViewAverage()
-
-// update the colors of a single cell
-void ViewAverage::update(unsigned int position, int color,
-                         std::uint64_t generations_,
-                         unsigned int ideal_color_) {
-    // get RGB data from hex value
-    std::uint_fast8_t red = ((color >> 16) & 0xFF);
-    std::uint_fast8_t green = ((color >> 8) & 0xFF);
-    std::uint_fast8_t blue = color & 0xFF;
-
-    // multi position by length of block to get start of pos block
-    position *= RGBA_BLOCK;
-    color_map[position + R_POS] = red;
-    color_map[position + G_POS] = green;
-    color_map[position + B_POS] = blue;
-    color_map[position + A_POS] = FULL_ALPHA;
+// draw the cells of the model's board, each colored 0xRRGGBB and black if
+// dead, into the texture if it has stepped or the view has moved since they
+// were last drawn
+void ViewAverage::render(GridView<std::uint32_t> colors) {
+    if (!needs_render()) {
+        return;
+    } // if
+    ScopedPhase phase(timers, PhaseTimers::TEXTURE);
+    if (is_full_detail()) {
+        // each channel is shifted into place, so a run of cells can be
+        // converted at once
+        const std::uint32_t opaque = to_pixel(0);
+        const unsigned int red_shift = channel_shift(0xFF0000);
+        const unsigned int green_shift = channel_shift(0x00FF00);
+        const unsigned int blue_shift = channel_shift(0x0000FF);
+        const unsigned int shown = width - origin_x;
+        draw_rows([&](unsigned int begin, unsigned int end) {
+            for (unsigned int row = begin; row < end; ++row) {
+                const std::uint32_t *cells =
+                        colors.row_data(origin_y + row) + origin_x;
+                draw_row(row, [&](unsigned int col, std::uint32_t *run) {
+                    // the last run of a row can reach past the board, so
+                    // it's read from a copy
+                    const std::uint32_t *from = cells + col;
+                    std::uint32_t last[CELLS_PER_RUN] = {};
+                    if (col + CELLS_PER_RUN > shown) {
+                        std::copy(from, cells + shown, last);
+                        from = last;
+                    } // if
+                    for (unsigned int cell = 0; cell < CELLS_PER_RUN; ++cell) {
+                        std::uint32_t color = from[cell];
+                        run[cell] = opaque |
+                                    (((color >> 16) & 0xFF) << red_shift) |
+                                    (((color >> 8) & 0xFF) << green_shift) |
+                                    ((color & 0xFF) << blue_shift);
+                    } // for
+                });
+            } // for
+        });
+    } else {
+        // a box of cells is the average of their colors; the channels of
+        // each column are added up down the box first
+        const unsigned int span = box_edges.back() - origin_x;
+        draw_rows([&](unsigned int begin, unsigned int end) {
+            std::vector<std::uint32_t> reds(span), greens(span), blues(span);
+            std::vector<std::uint64_t> sums(3 * run_cols());
+            for (unsigned int row = begin; row < end; ++row) {
+                std::fill(reds.begin(), reds.end(), 0);
+                std::fill(greens.begin(), greens.end(), 0);
+                std::fill(blues.begin(), blues.end(), 0);
+                for (unsigned int y = box_top(row); y < box_bottom(row); ++y) {
+                    const std::uint32_t *cells =
+                            colors.row_data(y) + origin_x;
+                    for (unsigned int x = 0; x < span; ++x) {
+                        reds[x] += (cells[x] >> 16) & 0xFF;
+                        greens[x] += (cells[x] >> 8) & 0xFF;
+                        blues[x] += cells[x] & 0xFF;
+                    } // for
+                } // for
+                std::fill(sums.begin(), sums.end(), 0);
+                for (unsigned int col = 0; col < texture_cols; ++col) {
+                    std::uint64_t *sum = &sums[3 * col];
+                    for (unsigned int x = box_edges[col] - origin_x;
+                         x < box_edges[col + 1] - origin_x; ++x) {
+                        sum[0] += reds[x];
+                        sum[1] += greens[x];
+                        sum[2] += blues[x];
+                    } // for
+                } // for
+                draw_row(row, [&](unsigned int col, std::uint32_t *run) {
+                    for (unsigned int cell = 0; cell < CELLS_PER_RUN; ++cell) {
+                        unsigned int x = col + cell;
+                        std::uint64_t area = std::max<std::uint64_t>(
+                                box_area(row, x), 1);
+                        const std::uint64_t *sum = &sums[3 * x];
+                        run[cell] = to_pixel(static_cast<unsigned int>(
+                                (sum[0] / area) << 16 | (sum[1] / area) << 8 |
+                                sum[2] / area));
+                    } // for
+                });
+            } // for
+        });
+    } // if/else
+    upload_texture();
+} // render()
 
-    generations = generations_;
+// set the ideal color shown in the title bar
+void ViewAverage::set_ideal_color(unsigned int ideal_color_) {
     ideal_color = ideal_color_;
-    model_was_updated = true;
-} // update()
+} // set_ideal_color()
 
 // display the grid
 void ViewAverage::display() {
-    if (model_was_updated) {
-        texture.update(&color_map[0]);
-        model_was_updated = false;
-    } // if
+    ScopedPhase phase(timers, PhaseTimers::DRAW);
 
     std::stringstream stream;
     stream << "generation: " << std::to_string(generations) << ", "
            << "ideal color: 0x" << std::uppercase << std::hex
            << static_cast<uintptr_t>(ideal_color)
-           << ", recording: " << std::boolalpha << is_recording;
+           << ", recording: " << std::boolalpha << is_recording
+           << turbo_title() << timing_title();
     window.setTitle(std::string(stream.str()));
     window.draw(sprite);
 } // display()
 
-// write a row of data to an output file
-void ViewAverage::write_data(unsigned int num_alive_,
-                             double average_mutation_rate,
-                             double average_fitness, double fitness_deviation) {
-    to_write += std::to_string(generations);
-    to_write += ',';
-    to_write += std::to_string(ideal_color);
-    to_write += ',';
-    to_write += std::to_string(num_alive_);
-    to_write += ',';
-    to_write += std::to_string(average_mutation_rate);
-    to_write += ',';
-    to_write += std::to_string(average_fitness);
-    to_write += ',';
-    to_write += std::to_string(fitness_deviation);
-    to_write += '\n';
-    size_t temp = to_write.size();
-    if (temp >= WRITE_DELTA) {
-        output_file << to_write;
-        to_write.clear();
-        to_write.reserve(WRITE_DELTA);
-    }
-} // write_date()
-
-// toggle recording on and off, writing to the output file
-void ViewAverage::toggle_recording() {
-    if (output_file.is_open()) {
-        output_file << to_write;
-        to_write.clear();
-    }
-    is_recording = !is_recording;
-    if (is_recording) {
-        output_file.close();
-        std::string name = output_file_name;
-        name += '_';
-        name += std::to_string(extension_num);
-        name += ".csv";
-        std::cout << name << std::endl;
-        output_file.open(name, std::fstream::out);
-        if (!output_file.is_open()) {
-            assert(false);
-        }
-        to_write +=
-                "Generation,Ideal Color,Living,Mutation Rate,Fitness,Fitness "
-                "Deviation\n";
-        ++extension_num;
-    }
-}
+// show whether the model is recording data
+void ViewAverage::set_recording(bool is_recording_) {
+    is_recording = is_recording_;
+} // set_recording()
 
 } // namespace GameOfLife
@@ -6,31 +6,36 @@
 #ifndef ViewAverage_hpp
 #define ViewAverage_hpp
 
+#include "GridView.hpp"
 #include "View.hpp"
+#include <cstdint>
 #include <stdio.h>
 namespace GameOfLife {
 
 class ViewAverage : public View {
 public:
     ViewAverage(unsigned int width, unsigned int height,
-                sf::RenderWindow &window, std::string output_file_name);
-    // write any remaining data to file
-    ~ViewAverage();
-    // update the colors of a single cell
-    void update(unsigned int position, int color, std::uint64_t generations_,
-                unsigned int ideal_color_);
-    // write a row of data to an output file
-    void write_data(unsigned int num_alive, double average_mutation_rate,
-                    double average_fitness, double fitness_deviation);
+                sf::RenderWindow &window);
+    // draw the cells of the model's board, each colored 0xRRGGBB and black
+    // if dead, into the texture if it has stepped or the view has moved
+    // since they were last drawn
+    void render(GridView<std::uint32_t> colors);
+    // set the ideal color shown in the title bar
+    void set_ideal_color(unsigned int ideal_color_);
     // display the grid
     void display() override;
-    // toggle recording on and off, writing to the output file
-    void toggle_recording();
+    // show whether the model is recording data
+    void set_recording(bool is_recording_);
 
 private:
+    // the lowest bit of a pixel that a channel of a color packed as 0xRRGGBB
+    // lands in, which depends on the machine's byte order
+    static unsigned int channel_shift(unsigned int channel_mask) {
+        return static_cast<unsigned int>(
+                __builtin_ctz(to_pixel(channel_mask) ^ to_pixel(0)));
+    }
+
     unsigned int ideal_color;
-    std::string to_write;
-    static constexpr unsigned int WRITE_DELTA = 1000;
     bool is_recording;
 };
 
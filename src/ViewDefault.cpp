@@ -3,42 +3,90 @@
  * A view class to handle the default game mode.
  */
 #include "ViewDefault.hpp"
+#include <vector>
 
 namespace GameOfLife {
 
 ViewDefault::ViewDefault(unsigned int width, unsigned int height,
-                         sf::RenderWindow &window, std::string output_file_name)
-        : View(width, height, window, output_file_name) {} // ViewDefault()
+                         sf::RenderWindow &window)
+        : View(width, height, window), step_exponent(0),
+          fast_forward_error(nullptr) {} // ViewDefault()
 
-// update the colors of a single cell
-void ViewDefault::update(unsigned int position, int color,
-                         std::uint64_t generations_) {
-    // get RGB data from hex value
-    std::uint_fast8_t red = ((color >> 16) & 0xFF);
-    std::uint_fast8_t green = ((color >> 8) & 0xFF);
-    std::uint_fast8_t blue = color & 0xFF;
-
-    // multi position by length of block to get start of pos block
-    position *= RGBA_BLOCK;
-    color_map[position + R_POS] = red;
-    color_map[position + G_POS] = green;
-    color_map[position + B_POS] = blue;
-    color_map[position + A_POS] = FULL_ALPHA;
-
-    generations = generations_;
-    model_was_updated = true;
-} // update()
+// draw the cells of the model's board into the texture if it has stepped
+// or the view has moved since they were last drawn
+void ViewDefault::render(const BitGrid &grid) {
+    if (!needs_render()) {
+        return;
+    } // if
+    ScopedPhase phase(timers, PhaseTimers::TEXTURE);
+    // living cells are white, dead cells are black
+    const std::uint32_t dead = to_pixel(0x000000);
+    const std::uint32_t flip = dead ^ to_pixel(0xFFFFFF);
+    if (is_full_detail()) {
+        draw_rows([&](unsigned int begin, unsigned int end) {
+            for (unsigned int row = begin; row < end; ++row) {
+                const std::uint64_t *words = grid.row_data(origin_y + row);
+                draw_row(row, [&](unsigned int col, std::uint32_t *run) {
+                    const std::uint32_t *living =
+                            cell_masks(words, origin_x + col);
+                    for (unsigned int cell = 0; cell < CELLS_PER_RUN; ++cell) {
+                        run[cell] = dead ^ (living[cell] & flip);
+                    } // for
+                });
+            } // for
+        });
+    } else {
+        // a box of cells is the gray of how many of them are alive
+        draw_rows([&](unsigned int begin, unsigned int end) {
+            BoxCounter counter(grid.get_words_per_row());
+            std::vector<std::uint32_t> counts(run_cols());
+            for (unsigned int row = begin; row < end; ++row) {
+                std::fill(counts.begin(), counts.end(), 0);
+                for (unsigned int y = box_top(row); y < box_bottom(row); ++y) {
+                    counter.add_row(grid.row_data(y));
+                } // for
+                counter.take_counts(box_edges, counts.data());
+                draw_row(row, [&](unsigned int col, std::uint32_t *run) {
+                    for (unsigned int cell = 0; cell < CELLS_PER_RUN; ++cell) {
+                        unsigned int x = col + cell;
+                        unsigned int gray =
+                                coverage(counts[x], box_area(row, x));
+                        run[cell] = to_pixel(gray * 0x010101);
+                    } // for
+                });
+            } // for
+        });
+    } // if/else
+    upload_texture();
+} // render()
 
 // display the grid
 void ViewDefault::display() {
-    if (model_was_updated) {
-        texture.update(&color_map[0]);
-        model_was_updated = false;
-    } // if
+    ScopedPhase phase(timers, PhaseTimers::DRAW);
     std::string title = "generation: ";
     title += std::to_string(generations);
+    if (step_exponent > 0) {
+        title += ", step: 2^";
+        title += std::to_string(step_exponent);
+    } // if
+    if (fast_forward_error != nullptr) {
+        title += ", no fast-forward: ";
+        title += fast_forward_error;
+    } // if
+    title += turbo_title();
+    title += timing_title();
     window.setTitle(title);
     window.draw(sprite);
 } // display()
 
+// show how many generations each update advances
+void ViewDefault::set_step_exponent(unsigned int step_exponent_) {
+    step_exponent = step_exponent_;
+} // set_step_exponent()
+
+// show why the board isn't being fast-forwarded, or nothing if error is null
+void ViewDefault::set_fast_forward_error(const char *error) {
+    fast_forward_error = error;
+} // set_fast_forward_error()
+
 } // namespace GameOfLife
@@ -5,6 +5,7 @@
 #ifndef ViewDefault_hpp
 #define ViewDefault_hpp
 
+#include "BitGrid.hpp"
 #include "View.hpp"
 #include <stdio.h>
 namespace GameOfLife {
@@ -12,9 +13,20 @@ namespace GameOfLife {
 class ViewDefault : public View {
 public:
     ViewDefault(unsigned int width, unsigned int height,
-                sf::RenderWindow &window, std::string output_file_name);
-    void update(unsigned int position, int color, std::uint64_t generations_);
+                sf::RenderWindow &window);
+    // draw the cells of the model's board into the texture if it has
+    // stepped or the view has moved since they were last drawn
+    void render(const BitGrid &grid);
     void display() override;
+    // show how many generations each update advances
+    void set_step_exponent(unsigned int step_exponent_);
+    // show why the board isn't being fast-forwarded, or nothing if error is
+    // null
+    void set_fast_forward_error(const char *error);
+
+private:
+    unsigned int step_exponent;
+    const char *fast_forward_error;
 };
 
 } // namespace GameOfLife
@@ -0,0 +1,331 @@
+/*
+ *  bench.cpp
+ *  Measures how fast each game mode steps without a window, across board
+ *  sizes, densities and thread counts. Each case runs in its own process so
+ *  its peak memory is its own, and the results are printed as CSV, which can
+ *  be stored and compared against by a later run to catch regressions.
+ */
+
+#include "ModelAllele.hpp"
+#include "ModelAverage.hpp"
+#include "ModelDefault.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+// the densities each mode is measured at, its sample setting and another
+static const std::map<std::string, std::vector<std::string>> DENSITIES{
+        {"Default", {"0.1", "0.42"}},
+        {"Average", {"0.025", "0.25"}},
+        {"Allele", {"0.1", "0.29"}}};
+// rounds each case is timed in; the fastest counts, since other work on the
+// machine only ever slows a round down
+static constexpr int ROUNDS = 3;
+static const char *HEADER = "Mode,Width,Height,Density,Threads,Generations,"
+                            "Seconds,Generations/s,ns/Cell,Peak RSS KB";
+
+// one board to measure
+struct BenchCase {
+    std::string mode;
+    unsigned int width;
+    unsigned int height;
+    std::string density;
+    unsigned int threads;
+};
+
+// the measurements of a case
+struct BenchResult {
+    std::uint64_t generations;
+    double seconds;
+    // generations per second of the fastest round
+    double rate;
+    long peak_rss_kb;
+};
+
+// struct to hold the settings of a benchmark run
+struct BenchSettings {
+    std::vector<std::string> modes{"Default", "Average", "Allele"};
+    std::vector<std::string> sizes{"512x320", "2048x2048", "16384x16384"};
+    // empty for the densities of each mode
+    std::vector<std::string> densities;
+    std::vector<unsigned int> threads;
+    // time each case is timed for, at least, over all of its rounds
+    double seconds = 1.0;
+    std::string baseline;
+    // slowdown from the baseline that counts as a regression, in percent
+    double tolerance = 10.0;
+};
+
+// exit with an error message
+static void fail(const std::string &message) {
+    std::cerr << "Error: " << message << std::endl;
+    exit(1);
+} // fail()
+
+// split a list of values separated by commas
+static std::vector<std::string> split(const std::string &list) {
+    std::vector<std::string> items;
+    std::istringstream stream(list);
+    for (std::string item; getline(stream, item, ',');) {
+        items.push_back(item);
+    } // for
+    return items;
+} // split()
+
+// the memory the process has held at most, in kilobytes
+static long peak_rss_kb() {
+#if defined(__unix__) || defined(__APPLE__)
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#else
+    return 0;
+#endif
+} // peak_rss_kb()
+
+// make the model of a case, with the sample settings of its mode
+static std::unique_ptr<GameOfLife::Model> make_model(const BenchCase &c) {
+    // every case starts from the same board
+    GameOfLife::ModelOptions options;
+    options.seed = 1;
+    options.threads = c.threads;
+    double prob_alive = std::stod(c.density);
+    if (c.mode == "Default") {
+        return std::unique_ptr<GameOfLife::Model>(new GameOfLife::ModelDefault(
+                c.width, c.height, prob_alive, options, nullptr));
+    } else if (c.mode == "Average") {
+        return std::unique_ptr<GameOfLife::Model>(new GameOfLife::ModelAverage(
+                c.width, c.height, prob_alive, true, 0.00001, 0.0005,
+                0x0000FF, options, nullptr, ""));
+    } // if
+    return std::unique_ptr<GameOfLife::Model>(new GameOfLife::ModelAllele(
+            c.width, c.height, prob_alive, 0.7, options, nullptr, ""));
+} // make_model()
+
+// step the board of a case for at least the given number of seconds over
+// every round, not counting the time to fill it or the first generation
+static BenchResult run_case(const BenchCase &c, double seconds) {
+    std::unique_ptr<GameOfLife::Model> model = make_model(c);
+    model->update();
+    BenchResult result{0, 0.0, 0.0, 0};
+    for (int round = 0; round < ROUNDS; ++round) {
+        std::uint64_t generations = 0;
+        double elapsed = 0.0;
+        std::chrono::steady_clock::time_point start =
+                std::chrono::steady_clock::now();
+        do {
+            model->update();
+            ++generations;
+            std::chrono::duration<double> since =
+                    std::chrono::steady_clock::now() - start;
+            elapsed = since.count();
+        } while (elapsed < seconds / ROUNDS);
+        result.generations += generations;
+        result.seconds += elapsed;
+        result.rate = std::max(result.rate,
+                               static_cast<double>(generations) / elapsed);
+    } // for
+    result.peak_rss_kb = peak_rss_kb();
+    return result;
+} // run_case()
+
+// run a case in a process of its own, so its peak memory is measured apart
+// from every other case and running out of memory only loses that case;
+// returns whether it finished
+static bool run_isolated(const BenchCase &c, double seconds,
+                         BenchResult &result) {
+#if defined(__unix__) || defined(__APPLE__)
+    int fds[2];
+    if (pipe(fds) != 0) {
+        fail("Can't create a pipe");
+    } // if
+    pid_t pid = fork();
+    if (pid < 0) {
+        fail("Can't start a process");
+    } else if (pid == 0) {
+        close(fds[0]);
+        BenchResult measured = run_case(c, seconds);
+        ssize_t written = write(fds[1], &measured, sizeof(measured));
+        _exit(written == static_cast<ssize_t>(sizeof(measured)) ? 0 : 1);
+    } // if
+    close(fds[1]);
+    std::size_t got = 0;
+    char *bytes = reinterpret_cast<char *>(&result);
+    while (got < sizeof(result)) {
+        ssize_t count = read(fds[0], bytes + got, sizeof(result) - got);
+        if (count <= 0) {
+            break;
+        } // if
+        got += static_cast<std::size_t>(count);
+    } // while
+    close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return got == sizeof(result) && WIFEXITED(status) &&
+           WEXITSTATUS(status) == 0;
+#else
+    // without processes to isolate cases in, peak memory is the whole run's
+    result = run_case(c, seconds);
+    return true;
+#endif
+} // run_isolated()
+
+// the fields that identify a case in the results
+static std::string case_key(const BenchCase &c) {
+    return c.mode + ',' + std::to_string(c.width) + ',' +
+           std::to_string(c.height) + ',' + c.density + ',' +
+           std::to_string(c.threads);
+} // case_key()
+
+// read the generations per second of each case from stored results
+static std::map<std::string, double> read_baseline(const std::string &file) {
+    std::ifstream in(file);
+    if (!in.is_open()) {
+        fail("Can't read " + file);
+    } // if
+    std::map<std::string, double> rates;
+    std::string line;
+    getline(in, line);
+    while (getline(in, line)) {
+        std::vector<std::string> fields = split(line);
+        if (fields.size() < 8) {
+            continue;
+        } // if
+        std::string key = fields[0];
+        for (int field = 1; field < 5; ++field) {
+            key += ',' + fields[field];
+        } // for
+        rates[key] = std::stod(fields[7]);
+    } // while
+    return rates;
+} // read_baseline()
+
+// read in the settings of a run from the command line
+static BenchSettings read_arguments(int argc, char **argv) {
+    BenchSettings out;
+    for (int arg = 1; arg < argc; ++arg) {
+        std::string flag = argv[arg];
+        if (arg + 1 == argc) {
+            fail("Missing value for " + flag);
+        } // if
+        std::string value = argv[++arg];
+        if (flag == "--modes") {
+            out.modes = split(value);
+        } else if (flag == "--sizes") {
+            out.sizes = split(value);
+        } else if (flag == "--densities") {
+            out.densities = split(value);
+        } else if (flag == "--threads") {
+            for (const std::string &threads : split(value)) {
+                out.threads.push_back(
+                        static_cast<unsigned int>(std::stoi(threads)));
+            } // for
+        } else if (flag == "--seconds") {
+            out.seconds = std::stod(value);
+        } else if (flag == "--baseline") {
+            out.baseline = value;
+        } else if (flag == "--tolerance") {
+            out.tolerance = std::stod(value);
+        } else {
+            fail("Unknown option " + flag);
+        } // if
+    }     // for
+    for (const std::string &mode : out.modes) {
+        if (DENSITIES.count(mode) == 0) {
+            fail("Invalid mode \"" + mode + "\"");
+        } // if
+    }     // for
+    // one thread, and every core
+    if (out.threads.empty()) {
+        out.threads.push_back(1);
+        unsigned int cores = std::thread::hardware_concurrency();
+        if (cores > 1) {
+            out.threads.push_back(cores);
+        } // if
+    }     // if
+    return out;
+} // read_arguments()
+
+// Measure every combination of mode, size, density and thread count, and
+// compare them with a baseline if given
+int main(int argc, char **argv) {
+    BenchSettings settings = read_arguments(argc, argv);
+    std::map<std::string, double> baseline;
+    if (!settings.baseline.empty()) {
+        baseline = read_baseline(settings.baseline);
+    } // if
+
+    std::cout << HEADER;
+    if (!settings.baseline.empty()) {
+        std::cout << ",Baseline Generations/s,Change %";
+    } // if
+    std::cout << std::endl;
+
+    int regressions = 0;
+    for (const std::string &mode : settings.modes) {
+        for (const std::string &size : settings.sizes) {
+            BenchCase c;
+            c.mode = mode;
+            std::size_t x = size.find('x');
+            if (x == std::string::npos) {
+                fail("Invalid size \"" + size + "\"");
+            } // if
+            c.width = static_cast<unsigned int>(std::stoi(size.substr(0, x)));
+            c.height =
+                    static_cast<unsigned int>(std::stoi(size.substr(x + 1)));
+            const std::vector<std::string> &densities =
+                    settings.densities.empty() ? DENSITIES.at(mode)
+                                               : settings.densities;
+            for (const std::string &density : densities) {
+                c.density = density;
+                for (unsigned int threads : settings.threads) {
+                    c.threads = threads;
+                    BenchResult result;
+                    if (!run_isolated(c, settings.seconds, result)) {
+                        std::cerr << "Failed: " << case_key(c) << std::endl;
+                        continue;
+                    } // if
+                    double rate = result.rate;
+                    double cells = static_cast<double>(c.width) * c.height;
+                    std::cout << case_key(c) << ',' << result.generations
+                              << ',' << result.seconds << ',' << rate << ','
+                              << 1e9 / (rate * cells) << ','
+                              << result.peak_rss_kb;
+                    double change = 0.0;
+                    auto found = baseline.find(case_key(c));
+                    if (found != baseline.end()) {
+                        change = 100.0 * (rate / found->second - 1.0);
+                        std::cout << ',' << found->second << ',' << change;
+                    } else if (!settings.baseline.empty()) {
+                        std::cout << ",,";
+                    } // if
+                    std::cout << std::endl;
+                    if (change < -settings.tolerance) {
+                        std::cerr << "Regression: " << case_key(c) << " "
+                                  << change << "%" << std::endl;
+                        ++regressions;
+                    } // if
+                } // for
+            }     // for
+        }         // for
+    }             // for
+
+    return regressions > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -16,6 +16,8 @@
 #include <SFML/Graphics.hpp>
 #include <algorithm>
 #include <cctype>
+#include <chrono>
+#include <cstdint>
 #include <iostream>
 #include <locale>
 #include <string>
@@ -23,6 +25,7 @@
 
 static constexpr float DELAY_DELTA = 0.005f;
 static float DELAY = 0;
+static unsigned int TURBO = 0;
 
 // trim whitespace from an input string
 static inline void trim(std::string &s) {
@@ -34,9 +37,103 @@ static inline void trim(std::string &s) {
             s.end());
 }
 
-// struct to hold all the settings for the basic Game of Life mode
-struct DefaultSettings {
+// settings shared by every game mode
+struct CommonSettings {
     std::string output_file;
+    GameOfLife::ModelOptions options;
+    // generations to run without a window, or zero to open one
+    std::uint64_t headless_generations = 0;
+    // whether to time where each frame goes, and the name of the files to
+    // log the timings to, if any
+    bool timing = false;
+    std::string timing_log;
+    // milliseconds of each frame to spend stepping at the top turbo level,
+    // or zero for all of it
+    double frame_budget = 0;
+};
+
+// read a setting shared by every game mode, which may appear anywhere in the
+// file, returning whether line was one
+static bool read_option(const std::string &line, CommonSettings &settings) {
+    GameOfLife::ModelOptions &options = settings.options;
+    std::string key = line.substr(0, line.find_first_of(":"));
+    std::string value = line.substr(line.find_first_of(":") + 1);
+    trim(key);
+    trim(value);
+    if (key == "SEED") {
+        options.seed = std::stoull(value);
+        return true;
+    } else if (key == "THREADS") {
+        options.threads = static_cast<unsigned int>(std::stoi(value));
+        return true;
+    } else if (key == "RULE") {
+        if (!GameOfLife::Rule::is_valid(value)) {
+            std::cerr << "Error: Invalid rule \"" << value << "\"" << std::endl;
+            exit(1);
+        } // if
+        options.rule = value;
+        return true;
+    } else if (key == "BOUNDARY") {
+        if (value != "DEAD" && value != "TORUS") {
+            std::cerr << "Error: Invalid boundary \"" << value << "\""
+                      << std::endl;
+            exit(1);
+        } // if
+        options.toroidal = value == "TORUS";
+        return true;
+    } else if (key == "HEADLESS") {
+        settings.headless_generations = std::stoull(value);
+        return true;
+    } else if (key == "TIMING") {
+        settings.timing = value == "ON";
+        return true;
+    } else if (key == "TIMING LOG") {
+        settings.timing = true;
+        settings.timing_log = value;
+        return true;
+    } else if (key == "FRAME BUDGET") {
+        settings.frame_budget = std::stod(value);
+        return true;
+    } // if
+    return false;
+} // read_option()
+
+// speed up the evolution with the right key or slow it down with the left:
+// the delay between generations shrinks to zero first, then each turbo level
+// steps more generations per frame
+static void change_speed(const sf::Event &event,
+                         GameOfLife::Controller &controller) {
+    if (event.key.code == sf::Keyboard::Right) {
+        if (DELAY >= DELAY_DELTA) {
+            DELAY -= DELAY_DELTA;
+        } else if (TURBO < GameOfLife::Controller::TURBO_LEVELS) {
+            DELAY = 0;
+            ++TURBO;
+        } // if
+    } else if (event.key.code == sf::Keyboard::Left) {
+        if (TURBO > 0) {
+            --TURBO;
+        } else {
+            DELAY += DELAY_DELTA;
+        } // if
+    } else {
+        return;
+    } // if
+    controller.set_speed(DELAY, TURBO);
+} // change_speed()
+
+// exit with an error if the rule can give birth to cells without parents
+static void require_parents(const GameOfLife::ModelOptions &options) {
+    if (!options.rule.empty() &&
+        GameOfLife::Rule(options.rule).births_without_neighbors()) {
+        std::cerr << "Error: Rule \"" << options.rule
+                  << "\" gives birth without neighbors." << std::endl;
+        exit(1);
+    } // if
+} // require_parents()
+
+// struct to hold all the settings for the basic Game of Life mode
+struct DefaultSettings : CommonSettings {
     unsigned int window_width;
     unsigned int window_height;
     unsigned int grid_width;
@@ -53,6 +150,7 @@ DefaultSettings read_default(std::istream &is, const std::string &output) {
     while (getline(is, line)) {
         // skip comments and empty lines
         if (line.empty() || line.compare(0, 2, "//") == 0) continue;
+        if (read_option(line, out)) continue;
 
         // delete prompt
         line.erase(0, line.find_first_of(":") + 1);
@@ -81,25 +179,73 @@ DefaultSettings read_default(std::istream &is, const std::string &output) {
     return out;
 } // read_default()
 
+// run model for the headless generations of settings without a window, as
+// fast as it can be stepped, stopping early once every cell has died for good
+static void run_headless(GameOfLife::Model &model,
+                         const CommonSettings &settings) {
+    GameOfLife::PhaseTimers timers;
+    if (settings.timing) {
+        timers.set_enabled(true);
+        if (!settings.timing_log.empty()) {
+            timers.set_log(settings.timing_log);
+        } // if
+        model.set_timers(&timers);
+    } // if
+    std::uint64_t cells =
+            static_cast<std::uint64_t>(model.get_width()) * model.get_height();
+    std::chrono::steady_clock::time_point start =
+            std::chrono::steady_clock::now();
+    while (model.get_generations() < settings.headless_generations &&
+           !model.is_extinct()) {
+        GameOfLife::ScopedPhase phase(&timers, GameOfLife::PhaseTimers::STEP);
+        model.update();
+    } // while
+    std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+    std::cout << "generations: " << model.get_generations()
+              << ", living: " << model.get_num_alive()
+              << ", seconds: " << elapsed.count() << std::endl;
+    // the whole run is summarized at once
+    if (settings.timing) {
+        timers.summarize(model.get_generations(), cells);
+        std::cout << timers.get_summary() << std::endl;
+    } // if
+    model.set_timers(nullptr);
+} // run_headless()
+
 // the main loop for the default game mode
-void main_default(std::istream &is) {
+void main_default(std::istream &is, std::uint64_t headless_generations) {
     // default doesn't currently record anything, so output file is just empty
     DefaultSettings set = read_default(is, std::string());
+    if (headless_generations > 0) {
+        set.headless_generations = headless_generations;
+    } // if
+    if (set.headless_generations > 0) {
+        GameOfLife::ModelDefault model(set.grid_width, set.grid_height,
+                                       set.prob_alive, set.options, nullptr);
+        run_headless(model, set);
+        return;
+    } // if
     // create
     sf::RenderWindow window(sf::VideoMode(set.window_width, set.window_height),
                             "0", sf::Style::Titlebar | sf::Style::Close);
-    window.setFramerateLimit(60);
+    window.setFramerateLimit(GameOfLife::Controller::FRAME_RATE);
 
     GameOfLife::ControllerDefault controller{set.grid_width, set.grid_height,
-                                             set.prob_alive, window,
-                                             set.output_file};
-
-    sf::Clock clock;
-    clock.restart();
+                                             set.prob_alive, set.options,
+                                             window};
+    if (set.timing) {
+        controller.enable_timing(set.timing_log);
+    } // if
+    if (set.frame_budget > 0) {
+        controller.set_frame_budget(set.frame_budget / 1000.0);
+    } // if
+    controller.set_speed(DELAY, TURBO);
 
     while (window.isOpen()) {
         sf::Event event;
         while (window.pollEvent(event)) {
+            controller.on_view_event(event);
             switch (event.type) {
                 // exit the game
                 case sf::Event::Closed:
@@ -107,12 +253,7 @@ void main_default(std::istream &is) {
                     break;
                 // spped up or slow down the evolution with left/right keys
                 case sf::Event::KeyPressed:
-                    if (event.key.code == sf::Keyboard::Right &&
-                        DELAY >= DELAY_DELTA) {
-                        DELAY -= DELAY_DELTA;
-                    } else if (event.key.code == sf::Keyboard::Left) {
-                        DELAY += DELAY_DELTA;
-                    }
+                    change_speed(event, controller);
                     controller.on_key_press(event);
                     break;
 
@@ -121,13 +262,9 @@ void main_default(std::istream &is) {
             }
         }
 
+        // the model is stepped on a thread of its own, so the window only
+        // shows its latest board
         window.clear();
-
-        if (clock.getElapsedTime().asSeconds() >= DELAY) {
-            controller.update_model();
-            clock.restart();
-        }
-
         controller.display_view();
 
         window.display();
@@ -135,8 +272,7 @@ void main_default(std::istream &is) {
 } // main_default()
 
 // struct to hold settings for average game mode
-struct AverageSettings {
-    std::string output_file;
+struct AverageSettings : CommonSettings {
     unsigned int window_width;
     unsigned int window_height;
     unsigned int grid_width;
@@ -157,6 +293,7 @@ AverageSettings read_average(std::istream &is, const std::string &output) {
     while (getline(is, line)) {
         // skip comments and empty lines
         if (line.empty() || line.compare(0, 2, "//") == 0) continue;
+        if (read_option(line, out)) continue;
 
         // delete prompt
         line.erase(0, line.find_first_of(":") + 1);
@@ -202,23 +339,44 @@ AverageSettings read_average(std::istream &is, const std::string &output) {
 } // read_average()
 
 // main method for average mode
-void main_average(std::istream &is, const std::string &output) {
+void main_average(std::istream &is, const std::string &output,
+                  std::uint64_t headless_generations) {
     AverageSettings set = read_average(is, output);
+    require_parents(set.options);
+    if (headless_generations > 0) {
+        set.headless_generations = headless_generations;
+    } // if
+    if (set.headless_generations > 0) {
+        // every generation is recorded
+        GameOfLife::ModelAverage model(
+                set.grid_width, set.grid_height, set.prob_alive, set.sexual,
+                set.min_mutation, set.max_mutation, set.ideal_color,
+                set.options, nullptr, set.output_file);
+        model.toggle_recording();
+        run_headless(model, set);
+        return;
+    } // if
     sf::RenderWindow window(sf::VideoMode(set.window_width, set.window_height),
                             "0", sf::Style::Titlebar | sf::Style::Close);
-    window.setFramerateLimit(60);
+    window.setFramerateLimit(GameOfLife::Controller::FRAME_RATE);
 
     GameOfLife::ControllerAverage controller{
             set.grid_width,  set.grid_height,  set.prob_alive,
             set.sexual,      set.min_mutation, set.max_mutation,
-            set.ideal_color, window,           set.output_file};
-
-    sf::Clock clock;
-    clock.restart();
+            set.ideal_color, set.options,      window,
+            set.output_file};
+    if (set.timing) {
+        controller.enable_timing(set.timing_log);
+    } // if
+    if (set.frame_budget > 0) {
+        controller.set_frame_budget(set.frame_budget / 1000.0);
+    } // if
+    controller.set_speed(DELAY, TURBO);
 
     while (window.isOpen()) {
         sf::Event event;
         while (window.pollEvent(event)) {
+            controller.on_view_event(event);
             switch (event.type) {
                 case sf::Event::Closed:
                     window.close();
@@ -226,12 +384,7 @@ void main_average(std::istream &is, const std::string &output) {
 
                 case sf::Event::KeyPressed:
                     // speed up or slow down the evolution with left/right keys
-                    if (event.key.code == sf::Keyboard::Right &&
-                        DELAY >= DELAY_DELTA) {
-                        DELAY -= DELAY_DELTA;
-                    } else if (event.key.code == sf::Keyboard::Left) {
-                        DELAY += DELAY_DELTA;
-                    }
+                    change_speed(event, controller);
                     controller.on_key_press(event);
                     break;
 
@@ -240,13 +393,9 @@ void main_average(std::istream &is, const std::string &output) {
             }
         }
 
+        // the model is stepped on a thread of its own, so the window only
+        // shows its latest board
         window.clear();
-
-        if (clock.getElapsedTime().asSeconds() >= DELAY) {
-            controller.update_model();
-            clock.restart();
-        }
-
         controller.display_view();
 
         window.display();
@@ -254,8 +403,7 @@ void main_average(std::istream &is, const std::string &output) {
 } // main_average()
 
 // struct to hold settings for average game mode
-struct AlleleSettings {
-    std::string output_file;
+struct AlleleSettings : CommonSettings {
     unsigned int window_width;
     unsigned int window_height;
     unsigned int grid_width;
@@ -273,6 +421,7 @@ AlleleSettings read_allele(std::istream &is, const std::string &output) {
     while (getline(is, line)) {
         // skip comments and empty lines
         if (line.empty() || line.compare(0, 2, "//") == 0) continue;
+        if (read_option(line, out)) continue;
 
         // delete prompt
         line.erase(0, line.find_first_of(":") + 1);
@@ -306,36 +455,51 @@ AlleleSettings read_allele(std::istream &is, const std::string &output) {
 } // read_average()
 
 // main method for average mode
-void main_allele(std::istream &is, const std::string &output) {
+void main_allele(std::istream &is, const std::string &output,
+                 std::uint64_t headless_generations) {
     AlleleSettings set = read_allele(is, output);
+    require_parents(set.options);
+    if (headless_generations > 0) {
+        set.headless_generations = headless_generations;
+    } // if
+    if (set.headless_generations > 0) {
+        // every generation is recorded
+        GameOfLife::ModelAllele model(set.grid_width, set.grid_height,
+                                      set.prob_alive, set.dom_frequency,
+                                      set.options, nullptr, set.output_file);
+        model.toggle_recording();
+        run_headless(model, set);
+        return;
+    } // if
 
     sf::RenderWindow window(sf::VideoMode(set.window_width, set.window_height),
                             "0", sf::Style::Titlebar | sf::Style::Close);
-    window.setFramerateLimit(60);
-
-    GameOfLife::ControllerAllele controller{set.grid_width, set.grid_height,
-                                            set.prob_alive, set.dom_frequency,
-                                            window,         set.output_file};
-
-    sf::Clock clock;
-    clock.restart();
+    window.setFramerateLimit(GameOfLife::Controller::FRAME_RATE);
+
+    GameOfLife::ControllerAllele controller{
+            set.grid_width,    set.grid_height, set.prob_alive,
+            set.dom_frequency, set.options,     window,
+            set.output_file};
+    if (set.timing) {
+        controller.enable_timing(set.timing_log);
+    } // if
+    if (set.frame_budget > 0) {
+        controller.set_frame_budget(set.frame_budget / 1000.0);
+    } // if
+    controller.set_speed(DELAY, TURBO);
 
     while (window.isOpen()) {
         sf::Event event;
         while (window.pollEvent(event)) {
             controller.update_geno();
+            controller.on_view_event(event);
             switch (event.type) {
                 case sf::Event::Closed:
                     window.close();
                     break;
 
                 case sf::Event::KeyPressed:
-                    if (event.key.code == sf::Keyboard::Right &&
-                        DELAY >= DELAY_DELTA) {
-                        DELAY -= DELAY_DELTA;
-                    } else if (event.key.code == sf::Keyboard::Left) {
-                        DELAY += DELAY_DELTA;
-                    }
+                    change_speed(event, controller);
                     controller.on_key_press(event);
                     break;
 
@@ -344,13 +508,9 @@ void main_allele(std::istream &is, const std::string &output) {
             }
         }
 
+        // the model is stepped on a thread of its own, so the window only
+        // shows its latest board
         window.clear();
-
-        if (clock.getElapsedTime().asSeconds() >= DELAY) {
-            controller.update_model();
-            clock.restart();
-        }
-
         controller.display_view();
 
         window.display();
@@ -360,31 +520,43 @@ void main_allele(std::istream &is, const std::string &output) {
 // Read in input / output files from the command line, then dispatch
 // to the appropriate game mode
 int main(int argc, char **argv) {
-    if (argc != 2 && argc != 3) {
-        std::cerr << "Usage: ./pixels SettingsFile [OutputFile]" << std::endl;
+    // --headless may appear anywhere, followed by the generations to run
+    std::vector<std::string> args;
+    std::uint64_t headless_generations = 0;
+    for (int arg = 1; arg < argc; ++arg) {
+        if (std::string(argv[arg]) == "--headless" && arg + 1 < argc) {
+            headless_generations = std::stoull(argv[++arg]);
+        } else {
+            args.push_back(argv[arg]);
+        } // if/else
+    }     // for
+    if (args.size() != 1 && args.size() != 2) {
+        std::cerr << "Usage: ./pixels [--headless Generations] SettingsFile "
+                     "[OutputFile]"
+                  << std::endl;
         exit(1);
     }
 
-    std::ifstream in(argv[1]);
+    std::ifstream in(args[0]);
     std::string mode;
     in >> mode;
 
     if (mode == "Default") {
-        main_default(in);
+        main_default(in, headless_generations);
     } else if (mode == "Average") {
-        if (argc != 3) {
+        if (args.size() != 2) {
             std::cerr << "Error: Must specify output file for Average mode."
                       << std::endl;
             exit(1);
         }
-        main_average(in, std::string(argv[2]));
+        main_average(in, args[1], headless_generations);
     } else if (mode == "Allele") {
-        if (argc != 3) {
+        if (args.size() != 2) {
             std::cerr << "Error: Must specify output file for Allele mode."
                       << std::endl;
             exit(1);
         }
-        main_allele(in, std::string(argv[2]));
+        main_allele(in, args[1], headless_generations);
     } else {
         std::cerr << "Error: Invalid game mode \"" << mode << "\"" << std::endl;
     }
@@ -0,0 +1,348 @@
+/*
+ *  sweep.cpp
+ *  Runs every combination of a set of parameters for the Default, Average or
+ *  Allele mode, each several times with its own seed, across every core of a
+ *  single process. The statistics of every run go to one results file, each
+ *  row tagged with the parameters and seed that produced it.
+ */
+
+#include "ModelAllele.hpp"
+#include "ModelAverage.hpp"
+#include "ModelDefault.hpp"
+#include "ModelEnsemble.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// the parameters of each game mode, in the order of their columns; each can
+// be given several values to sweep over
+static const std::vector<std::string> DEFAULT_PARAMETERS{
+        "GRID WIDTH", "GRID HEIGHT", "PROBABILITY ALIVE", "RULE", "BOUNDARY"};
+static const std::vector<std::string> AVERAGE_PARAMETERS{
+        "GRID WIDTH",        "GRID HEIGHT",       "PROBABILITY ALIVE",
+        "IDEAL COLOR",       "SEXUAL",            "MIN MUTATION RATE",
+        "MAX MUTATION RATE", "RULE",              "BOUNDARY"};
+static const std::vector<std::string> ALLELE_PARAMETERS{
+        "GRID WIDTH",    "GRID HEIGHT", "PROBABILITY ALIVE",
+        "DOMINANT FREQ", "RULE",        "BOUNDARY"};
+
+// trim whitespace from an input string
+static inline void trim(std::string &s) {
+    s.erase(s.begin(), std::find_if(s.begin(), s.end(),
+                                    [](int ch) { return !std::isspace(ch); }));
+    s.erase(std::find_if(s.rbegin(), s.rend(),
+                         [](int ch) { return !std::isspace(ch); })
+                    .base(),
+            s.end());
+}
+
+// struct to hold the settings of a sweep
+struct SweepSettings {
+    std::string mode;
+    // the parameters of the mode, and the values to sweep each over
+    std::vector<std::string> parameters;
+    std::map<std::string, std::vector<std::string>> values;
+    std::uint64_t generations = 0;
+    unsigned int replicates = 1;
+    // replicate r of every combination is seeded with seed + r
+    std::uint64_t seed = std::random_device{}();
+    unsigned int threads = 0;
+    // generations between rows of the results
+    std::uint64_t record_every = 1;
+    // whether replicates are stepped together, up to 64 at a time
+    bool ensemble = false;
+};
+
+// exit with an error message
+static void fail(const std::string &message) {
+    std::cerr << "Error: " << message << std::endl;
+    exit(1);
+} // fail()
+
+// read in the settings of a sweep from is
+SweepSettings read_sweep(std::istream &is) {
+    SweepSettings out;
+    is >> out.mode;
+    if (out.mode == "Default") {
+        out.parameters = DEFAULT_PARAMETERS;
+        out.values["RULE"] = {GameOfLife::ModelDefault::DEFAULT_RULE};
+    } else if (out.mode == "Average") {
+        out.parameters = AVERAGE_PARAMETERS;
+        out.values["RULE"] = {GameOfLife::ModelAverage::DEFAULT_RULE};
+    } else if (out.mode == "Allele") {
+        out.parameters = ALLELE_PARAMETERS;
+        out.values["RULE"] = {GameOfLife::ModelAllele::DEFAULT_RULE};
+    } else {
+        fail("Invalid sweep mode \"" + out.mode + "\"");
+    } // if
+    out.values["BOUNDARY"] = {"DEAD"};
+
+    std::string line;
+    while (getline(is, line)) {
+        trim(line);
+        // skip comments and empty lines
+        if (line.empty() || line.compare(0, 2, "//") == 0) continue;
+        std::string key = line.substr(0, line.find_first_of(":"));
+        std::string value = line.substr(line.find_first_of(":") + 1);
+        trim(key);
+        trim(value);
+        if (key == "GENERATIONS") {
+            out.generations = std::stoull(value);
+        } else if (key == "REPLICATES") {
+            out.replicates = static_cast<unsigned int>(std::stoi(value));
+        } else if (key == "SEED") {
+            out.seed = std::stoull(value);
+        } else if (key == "THREADS") {
+            out.threads = static_cast<unsigned int>(std::stoi(value));
+        } else if (key == "RECORD EVERY") {
+            out.record_every = std::max<std::uint64_t>(1, std::stoull(value));
+        } else if (key == "ENSEMBLE") {
+            out.ensemble = std::tolower(value[0]) == 't';
+        } else if (std::find(out.parameters.begin(), out.parameters.end(),
+                             key) != out.parameters.end()) {
+            // the values to sweep over are separated by whitespace
+            std::istringstream stream(value);
+            std::vector<std::string> &values = out.values[key];
+            values.clear();
+            for (std::string item; stream >> item;) {
+                values.push_back(item);
+            } // for
+        } else {
+            fail("Unknown setting \"" + key + "\"");
+        } // if
+    }     // while
+
+    for (const std::string &parameter : out.parameters) {
+        if (out.values[parameter].empty()) {
+            fail("Missing values for " + parameter);
+        } // if
+    }     // for
+    for (const std::string &rule : out.values["RULE"]) {
+        if (!GameOfLife::Rule::is_valid(rule) ||
+            GameOfLife::Rule(rule).births_without_neighbors()) {
+            fail("Invalid rule \"" + rule + "\"");
+        } // if
+    }     // for
+    for (const std::string &boundary : out.values["BOUNDARY"]) {
+        if (boundary != "DEAD" && boundary != "TORUS") {
+            fail("Invalid boundary \"" + boundary + "\"");
+        } // if
+    }     // for
+    if (out.generations == 0 || out.replicates == 0) {
+        fail("A sweep needs GENERATIONS and REPLICATES above zero");
+    } // if
+    if (out.ensemble && out.mode == "Average") {
+        fail("Average mode can't be run as an ensemble");
+    } // if
+    return out;
+} // read_sweep()
+
+// a value as a field of the results, quoted if it holds a comma
+static std::string to_field(const std::string &value) {
+    if (value.find(',') == std::string::npos) {
+        return value;
+    } // if
+    return '"' + value + '"';
+} // to_field()
+
+// step model for the sweep's generations, returning a row of its statistics
+// every so often, each starting with tags
+template <class ModelType>
+static std::vector<std::string> record(ModelType &model,
+                                      const SweepSettings &settings,
+                                      const std::vector<std::string> &tags) {
+    std::string rows;
+    while (model.get_generations() < settings.generations) {
+        model.update();
+        if (model.get_generations() % settings.record_every == 0) {
+            rows += tags[0];
+            rows += model.format_stats();
+            rows += '\n';
+        } // if
+    }     // while
+    return {rows};
+} // record()
+
+// step every replicate of ensemble for the sweep's generations, returning
+// the rows of each replicate, tagged with its own tags
+static std::vector<std::string>
+record(GameOfLife::ModelEnsemble &ensemble, const SweepSettings &settings,
+       const std::vector<std::string> &tags) {
+    std::vector<std::string> rows(ensemble.get_replicates());
+    while (ensemble.get_generations() < settings.generations) {
+        ensemble.update();
+        if (ensemble.get_generations() % settings.record_every != 0) {
+            continue;
+        } // if
+        for (unsigned int replicate = 0; replicate < rows.size();
+             ++replicate) {
+            rows[replicate] += tags[replicate];
+            rows[replicate] += ensemble.format_stats(replicate);
+            rows[replicate] += '\n';
+        } // for
+    }     // while
+    return rows;
+} // record()
+
+// run one simulation of each replicate in tags with the chosen value of each
+// parameter, returning the rows of the results of each, tagged with its tags
+static std::vector<std::string>
+simulate(const SweepSettings &settings,
+         std::map<std::string, std::string> &chosen,
+         const GameOfLife::ModelOptions &options,
+         const std::vector<std::string> &tags) {
+    unsigned int width =
+            static_cast<unsigned int>(std::stoi(chosen["GRID WIDTH"]));
+    unsigned int height =
+            static_cast<unsigned int>(std::stoi(chosen["GRID HEIGHT"]));
+    double prob_alive = std::stod(chosen["PROBABILITY ALIVE"]);
+    if (settings.ensemble) {
+        bool allele = settings.mode == "Allele";
+        GameOfLife::ModelEnsemble ensemble(
+                width, height, prob_alive, allele,
+                allele ? std::stod(chosen["DOMINANT FREQ"]) : 0.0,
+                static_cast<unsigned int>(tags.size()), options);
+        return record(ensemble, settings, tags);
+    } else if (settings.mode == "Default") {
+        GameOfLife::ModelDefault model(width, height, prob_alive, options,
+                                       nullptr);
+        return record(model, settings, tags);
+    } else if (settings.mode == "Average") {
+        GameOfLife::ModelAverage model(
+                width, height, prob_alive,
+                std::tolower(chosen["SEXUAL"][0]) == 't',
+                std::stod(chosen["MIN MUTATION RATE"]),
+                std::stod(chosen["MAX MUTATION RATE"]),
+                static_cast<unsigned int>(
+                        std::stoul(chosen["IDEAL COLOR"], nullptr, 16)),
+                options, nullptr, "");
+        return record(model, settings, tags);
+    } // if
+    GameOfLife::ModelAllele model(width, height, prob_alive,
+                                  std::stod(chosen["DOMINANT FREQ"]), options,
+                                  nullptr, "");
+    return record(model, settings, tags);
+} // simulate()
+
+// run every combination of parameters in the sweep, writing the results to
+// out in a fixed order
+void run_sweep(const SweepSettings &settings, std::ostream &out) {
+    std::uint64_t combinations = 1;
+    for (const std::string &parameter : settings.parameters) {
+        combinations *= settings.values.at(parameter).size();
+    } // for
+    unsigned int runs =
+            static_cast<unsigned int>(combinations * settings.replicates);
+
+    out << "Run,Replicate,Seed";
+    for (const std::string &parameter : settings.parameters) {
+        out << ',' << parameter;
+    } // for
+    out << ',';
+    if (settings.mode == "Default") {
+        out << GameOfLife::ModelDefault::STATS_HEADER;
+    } else if (settings.mode == "Average") {
+        out << GameOfLife::ModelAverage::STATS_HEADER;
+    } else {
+        out << GameOfLife::ModelAllele::STATS_HEADER;
+    } // if
+    out << '\n';
+
+    // each task runs one replicate of a combination, or as an ensemble up to
+    // 64 of them, stepping its board on one thread unless there are fewer
+    // tasks than threads to spread out
+    unsigned int lanes =
+            settings.ensemble ? GameOfLife::ModelEnsemble::MAX_REPLICATES : 1;
+    unsigned int groups = (settings.replicates + lanes - 1) / lanes;
+    unsigned int tasks = static_cast<unsigned int>(combinations * groups);
+    GameOfLife::ThreadPool pool(settings.threads);
+    unsigned int threads_per_task = std::max(1u, pool.size() / tasks);
+
+    // finished runs are written in order as soon as every run before them
+    // is done
+    std::mutex mutex;
+    std::vector<std::string> results(runs);
+    std::vector<bool> finished(runs, false);
+    unsigned int next_to_write = 0;
+    pool.run(tasks, [&](unsigned int task) {
+        unsigned int first_replicate = (task % groups) * lanes;
+        unsigned int count =
+                std::min(lanes, settings.replicates - first_replicate);
+        std::uint64_t combination = task / groups;
+        unsigned int first_run = static_cast<unsigned int>(
+                combination * settings.replicates + first_replicate);
+        // the combination numbers every choice of values, the first
+        // parameter varying fastest
+        std::map<std::string, std::string> chosen;
+        for (const std::string &parameter : settings.parameters) {
+            const std::vector<std::string> &values =
+                    settings.values.at(parameter);
+            chosen[parameter] = values[combination % values.size()];
+            combination /= values.size();
+        } // for
+
+        // replicate r of an ensemble starts from the board of a model
+        // seeded r higher
+        GameOfLife::ModelOptions options;
+        options.seed = settings.seed + first_replicate;
+        options.threads = threads_per_task;
+        options.rule = chosen["RULE"];
+        options.toroidal = chosen["BOUNDARY"] == "TORUS";
+
+        std::vector<std::string> tags(count);
+        for (unsigned int lane = 0; lane < count; ++lane) {
+            tags[lane] = std::to_string(first_run + lane) + ',' +
+                         std::to_string(first_replicate + lane) + ',' +
+                         std::to_string(options.seed + lane);
+            for (const std::string &parameter : settings.parameters) {
+                tags[lane] += ',';
+                tags[lane] += to_field(chosen[parameter]);
+            } // for
+            tags[lane] += ',';
+        } // for
+        std::vector<std::string> rows =
+                simulate(settings, chosen, options, tags);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        for (unsigned int lane = 0; lane < count; ++lane) {
+            results[first_run + lane].swap(rows[lane]);
+            finished[first_run + lane] = true;
+        } // for
+        while (next_to_write < runs && finished[next_to_write]) {
+            out << results[next_to_write];
+            std::string().swap(results[next_to_write]);
+            ++next_to_write;
+        } // while
+    });
+} // run_sweep()
+
+// Read in the sweep and results files from the command line, then run the
+// sweep
+int main(int argc, char **argv) {
+    if (argc != 3) {
+        std::cerr << "Usage: ./sweep SweepFile ResultsFile" << std::endl;
+        exit(1);
+    }
+
+    std::ifstream in(argv[1]);
+    if (!in.is_open()) {
+        fail(std::string("Can't read ") + argv[1]);
+    } // if
+    SweepSettings settings = read_sweep(in);
+    std::ofstream out(argv[2]);
+    if (!out.is_open()) {
+        fail(std::string("Can't write ") + argv[2]);
+    } // if
+    run_sweep(settings, out);
+
+    return EXIT_SUCCESS;
+}